@@ -4,3 +4,11 @@ def can_build(env, platform):
 
 def configure(env):
     pass
+
+
+def get_opts(platform):
+    return [
+        ("crashpad_dump_syms", "Path to Breakpad's dump_syms, for the crashpad_symbols target (searched for if empty)", ""),
+        ("crashpad_symbol_store", "Symbol store directory written by the crashpad_symbols target", "#bin/symbols"),
+        ("crashpad_symbol_binaries", "Other binaries to make symbols for (e.g. GDNative libraries), comma separated", ""),
+    ]
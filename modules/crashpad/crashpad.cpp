@@ -5,6 +5,8 @@
 #include "core/os/file_access.h"
 #include "core/os/dir_access.h"
 #include "core/project_settings.h"
+#include "core/io/json.h"
+#include "core/script_language.h"
 
 
 // We have to use ifdef because Crashpad is currently not supported on Linux
@@ -18,18 +20,20 @@
 #define NOMINMAX
 #endif
 
-// Needed for adding a delay to a thread so we can send the dump via curl
-#ifdef X11_ENABLED
-#include <chrono>
-#include <thread>
 #endif
 
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+#include "crashpad/client/simulate_crash.h"
 #endif
 
 // Static variables
 bool Crashpad::crashpad_skip_error_upload = false;
 Dictionary Crashpad::crashpad_user_crash_attributes = Dictionary();
 bool Crashpad::crashpad_upload_godot_log = false;
+int Crashpad::crashpad_log_attachment_mode = Crashpad::LOG_ATTACHMENT_FULL_FILE;
+int Crashpad::crashpad_log_tail_size_kb = 64;
+int Crashpad::crashpad_log_tail_lines = 0;
+CrashpadLogBuffer *Crashpad::crashpad_log_buffer = nullptr;
 // Crashpad variables
 String Crashpad::crashpad_api_URL = "";
 String Crashpad::crashpad_api_token = "";
@@ -38,33 +42,270 @@ String Crashpad::crashpad_application_path = "";
 bool Crashpad::crashpad_linux_delete_crashpad_database_data_on_start = true;
 bool Crashpad::crashpad_use_manual_application_extension = false;
 String Crashpad::crashpad_manual_application_extension = "";
+int Crashpad::crashpad_upload_connect_timeout = 5000;
+int Crashpad::crashpad_upload_total_timeout = 30000;
+int Crashpad::crashpad_linux_dump_wait_timeout = 5000;
+bool Crashpad::crashpad_linux_deferred_upload = false;
+int Crashpad::crashpad_deferred_upload_max_attempts = 5;
+int Crashpad::crashpad_deferred_upload_max_requests_per_minute = 6;
+int Crashpad::crashpad_deferred_upload_max_bytes_per_second = 0;
+int Crashpad::crashpad_dedupe_window_hours = 0;
+int Crashpad::crashpad_dedupe_stack_frames = 5;
+float Crashpad::crashpad_upload_sampling_percent = 100.0f;
+int Crashpad::crashpad_max_uploads_per_hour = 0;
+bool Crashpad::crashpad_session_tracking = false;
+String Crashpad::crashpad_session_events_url = "";
+int Crashpad::crashpad_session_batch_size = 20;
+bool Crashpad::crashpad_error_reporting = false;
+bool Crashpad::crashpad_capture_engine_errors = false;
+int Crashpad::crashpad_error_flush_interval = 60;
+int Crashpad::crashpad_error_max_batch_size = 50;
+int Crashpad::crashpad_max_uploads_per_signature_per_day = 0;
+int Crashpad::crashpad_upload_compression = CrashpadCompression::MODE_NONE;
+int Crashpad::crashpad_upload_compression_threshold = 16384;
+int Crashpad::crashpad_dump_profile = CrashpadMemoryRanges::DUMP_PROFILE_MINIMAL;
+bool Crashpad::crashpad_watchdog_enabled = false;
+int Crashpad::crashpad_watchdog_hang_threshold = 5000;
+bool Crashpad::crashpad_async_start = false;
+bool Crashpad::crashpad_shared_handler = false;
+String Crashpad::crashpad_shared_handler_name = "";
+bool Crashpad::crashpad_telemetry_enabled = false;
+int Crashpad::crashpad_telemetry_metrics = (1 << CrashpadTelemetry::METRIC_MAX) - 1;
+int Crashpad::crashpad_telemetry_sample_interval = 250;
+int Crashpad::crashpad_telemetry_window_size = 240;
+bool Crashpad::crashpad_screenshot_enabled = false;
+int Crashpad::crashpad_screenshot_interval = 10000;
+int Crashpad::crashpad_screenshot_max_dimension = 640;
+int Crashpad::crashpad_screenshot_max_size_kb = 256;
+
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+// Crashpad annotations are limited to 20 KiB, so keep the log tail under that
+#define CRASHPAD_LOG_TAIL_ANNOTATION_SIZE 16384
+// Filled in by the crash hook, then read out of the crashed process by the handler
+static crashpad::StringAnnotation<CRASHPAD_LOG_TAIL_ANNOTATION_SIZE> godot_log_tail_annotation("godot_log_tail");
+static char godot_log_tail_scratch[CRASHPAD_LOG_TAIL_ANNOTATION_SIZE];
+
+static void _write_log_tail_annotation(void *p_userdata)
+{
+    if (Crashpad::crashpad_log_buffer == nullptr)
+    {
+        return;
+    }
+    int max_bytes = MIN(Crashpad::crashpad_log_tail_size_kb * 1024, CRASHPAD_LOG_TAIL_ANNOTATION_SIZE - 1);
+    int length = Crashpad::crashpad_log_buffer->copy_tail(godot_log_tail_scratch, max_bytes, Crashpad::crashpad_log_tail_lines);
+    godot_log_tail_scratch[length] = '\0';
+    godot_log_tail_annotation.Set(godot_log_tail_scratch);
+}
+
+#define CRASHPAD_BREADCRUMBS_ANNOTATION_SIZE 16384
+static crashpad::StringAnnotation<CRASHPAD_BREADCRUMBS_ANNOTATION_SIZE> godot_breadcrumbs_annotation("godot_breadcrumbs");
+static char godot_breadcrumbs_scratch[CRASHPAD_BREADCRUMBS_ANNOTATION_SIZE];
+static CrashpadBreadcrumbs::Snapshot godot_breadcrumbs_snapshots[CrashpadBreadcrumbs::CAPACITY];
+
+static void _write_breadcrumbs_annotation(void *p_userdata)
+{
+    int length = CrashpadBreadcrumbs::write_text(godot_breadcrumbs_scratch, CRASHPAD_BREADCRUMBS_ANNOTATION_SIZE - 1, godot_breadcrumbs_snapshots);
+    godot_breadcrumbs_scratch[length] = '\0';
+    godot_breadcrumbs_annotation.Set(godot_breadcrumbs_scratch);
+}
+
+#define CRASHPAD_TELEMETRY_ANNOTATION_SIZE 16384
+static crashpad::StringAnnotation<CRASHPAD_TELEMETRY_ANNOTATION_SIZE> godot_telemetry_annotation("godot_telemetry");
+static char godot_telemetry_scratch[CRASHPAD_TELEMETRY_ANNOTATION_SIZE];
+
+static void _write_telemetry_annotation(void *p_userdata)
+{
+    const CrashpadTelemetry *telemetry = (const CrashpadTelemetry *)p_userdata;
+    int length = telemetry->write_csv(godot_telemetry_scratch, CRASHPAD_TELEMETRY_ANNOTATION_SIZE - 1);
+    godot_telemetry_scratch[length] = '\0';
+    godot_telemetry_annotation.Set(godot_telemetry_scratch);
+}
+
+#define CRASHPAD_SCRIPT_STACK_ANNOTATION_SIZE CrashpadScriptStack::MAX_TEXT_SIZE
+static crashpad::StringAnnotation<CRASHPAD_SCRIPT_STACK_ANNOTATION_SIZE> godot_script_stack_annotation("godot_script_stack");
+static char godot_script_stack_scratch[CRASHPAD_SCRIPT_STACK_ANNOTATION_SIZE];
+
+static void _write_script_stack_annotation(void *p_userdata)
+{
+    int length = CrashpadScriptStack::write_text(godot_script_stack_scratch, CRASHPAD_SCRIPT_STACK_ANNOTATION_SIZE - 1);
+    godot_script_stack_scratch[length] = '\0';
+    godot_script_stack_annotation.Set(godot_script_stack_scratch);
+}
+
+// The crash hook callbacks must not allocate. The first Set() of an annotation creates the process
+// annotation list if nobody registered it, and links the annotation into it, so do both up front.
+static void _register_crash_hook_annotations()
+{
+    if (crashpad::AnnotationList::Get() == nullptr)
+    {
+        crashpad::AnnotationList::Register();
+    }
+    godot_log_tail_annotation.Set("");
+    godot_breadcrumbs_annotation.Set("");
+    godot_telemetry_annotation.Set("");
+    godot_script_stack_annotation.Set("");
+}
+#endif
+
+
+void Crashpad::start_crashpad()
+{
+    if (crashpad_start_thread.is_started())
+    {
+        if (crashpad_start_pending.is_set())
+        {
+            WARN_PRINT("Crashpad is already starting!");
+            return;
+        }
+        crashpad_start_thread.wait_to_finish();
+    }
+
+    // Computed here, so the crash path never has to resolve paths
+    crashpad_early_crash_marker_path = OS::get_singleton()->get_user_data_dir().plus_file("godot_crashpad_early_crash");
+
+    // Loggers are only added on the main thread, as the OS logs from it all the time
+    if (Crashpad::crashpad_upload_godot_log == true && Crashpad::crashpad_log_attachment_mode == LOG_ATTACHMENT_MEMORY_BUFFER)
+    {
+        start_log_buffer();
+    }
+
+    if (Crashpad::crashpad_async_start == false)
+    {
+        emit_signal("crashpad_started", initialize_crashpad());
+        return;
+    }
+
+    // Until the handler is armed, a crash only leaves a marker behind (see write_early_crash_marker())
+    crashpad_start_pending.set();
+    crashpad_start_thread.start(_start_thread_func, this);
+}
+
+void Crashpad::_start_thread_func(void *p_userdata)
+{
+    Crashpad *self = (Crashpad *)p_userdata;
+    bool started = self->initialize_crashpad();
+    self->crashpad_start_pending.clear();
+    self->call_deferred("emit_signal", "crashpad_started", started);
+}
 
+void Crashpad::write_early_crash_marker()
+{
+    // Godot's own crash handler got the crash, but no dump will be written for it
+    FileAccess *file = FileAccess::open(crashpad_early_crash_marker_path, FileAccess::WRITE);
+    if (file == nullptr)
+    {
+        return;
+    }
+    file->store_line(itos(OS::get_singleton()->get_unix_time()));
+    file->close();
+    memdelete(file);
+}
 
-void Crashpad::start_crashpad() {
+void Crashpad::_early_crash_thread_func(void *p_userdata)
+{
+    ((Crashpad *)p_userdata)->report_early_crash();
+}
 
-#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined X11_ENABLED
-    // Make sure the application exists
-    if (check_for_crashpad_application() == false) {
-        String application_path = get_global_path_from_local_path(Crashpad::crashpad_application_path);
-        ERR_PRINT("Cannot find crashpad_handle application! Setup 'application_path' in editor to point to application! Input file path: " + application_path);
-        print_line("Crashpad Error: Cannot find crashpad_handle application! Setup 'application_path' in editor to point to application! Input file path: " + application_path);
+void Crashpad::report_early_crash()
+{
+    if (FileAccess::exists(crashpad_early_crash_marker_path) == false)
+    {
         return;
     }
-    // Make sure the crashpad database directory exists or create it if it does not
-    check_for_crashpad_database(true);
+    FileAccess *file = FileAccess::open(crashpad_early_crash_marker_path, FileAccess::READ);
+    if (file == nullptr)
+    {
+        return;
+    }
+    uint64_t crash_time = file->get_line().strip_edges().to_int64();
+    file->close();
+    memdelete(file);
+    // Reported at most once, even if sending it fails
+    DirAccess::remove_file_or_error(crashpad_early_crash_marker_path);
+
+    if (CrashpadRateLimiter::is_sampled(itos(crash_time), Crashpad::crashpad_upload_sampling_percent) == false)
+    {
+        return;
+    }
+
+    Dictionary attributes = Crashpad::crashpad_user_crash_attributes.duplicate();
+    attributes["error.message"] = "Crashed before the crash handler was started";
+    attributes["godot_early_crash"] = "true";
+
+    Dictionary thread;
+    thread["name"] = "main";
+    thread["fault"] = true;
+    thread["stack"] = Array();
+    Dictionary threads;
+    threads["main"] = thread;
+
+    String hash = (itos(crash_time) + OS::get_singleton()->get_unique_id() + itos(OS::get_singleton()->get_ticks_usec())).md5_text();
+    Dictionary record;
+    record["uuid"] = hash.substr(0, 8) + "-" + hash.substr(8, 4) + "-" + hash.substr(12, 4) + "-" + hash.substr(16, 4) + "-" + hash.substr(20, 12);
+    record["timestamp"] = crash_time;
+    record["lang"] = "c++";
+    record["langVersion"] = "";
+    record["agent"] = "godot-crashpad";
+    record["agentVersion"] = "1.0";
+    record["mainThread"] = "main";
+    record["threads"] = threads;
+    record["attributes"] = attributes;
+
+    crashpad_early_crash_uploader.connect_timeout_msec = Crashpad::crashpad_upload_connect_timeout;
+    crashpad_early_crash_uploader.total_timeout_msec = Crashpad::crashpad_upload_total_timeout;
+    CrashpadMemoryBody body;
+    body.set_data(JSON::print(record).utf8(), "application/json");
+    post_report(crashpad_early_crash_uploader, Crashpad::crashpad_api_URL + Crashpad::crashpad_api_token + "/json", &body, Vector<String>());
+    crashpad_early_crash_uploader.close();
+}
+
+bool Crashpad::initialize_crashpad() {
+
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+    // If nothing changed since the last launch that started the handler, the paths from then are reused
+    set_default_paths();
+    String startup_cache_path = CrashpadStartupCache::get_default_path();
+    String settings_key = OS::get_singleton()->get_executable_path() + "\n" + Crashpad::crashpad_application_path + "\n" + Crashpad::crashpad_database_path;
+    if (Crashpad::crashpad_use_manual_application_extension == true)
+    {
+        settings_key += "\n" + Crashpad::crashpad_manual_application_extension;
+    }
+    CrashpadStartupCache startup_cache;
+    bool startup_cache_valid = startup_cache.load(startup_cache_path) == OK && startup_cache.last_start_ok == true && startup_cache.is_valid_for(settings_key);
+
+    if (startup_cache_valid == false)
+    {
+        // Make sure the application exists
+        if (check_for_crashpad_application() == false) {
+            String application_path = get_global_path_from_local_path(Crashpad::crashpad_application_path);
+            ERR_PRINT("Cannot find crashpad_handle application! Setup 'application_path' in editor to point to application! Input file path: " + application_path);
+            print_line("Crashpad Error: Cannot find crashpad_handle application! Setup 'application_path' in editor to point to application! Input file path: " + application_path);
+            return false;
+        }
+        // Make sure the crashpad database directory exists or create it if it does not
+        check_for_crashpad_database(true);
+
+        startup_cache.settings_key = settings_key;
+        startup_cache.handler_path = get_global_crashpad_application_path();
+        startup_cache.database_path = get_global_path_from_local_path(Crashpad::crashpad_database_path);
+        startup_cache.update_handler_info();
+    }
 
 #if defined WINDOWS_ENABLED
-    base::FilePath::StringType database_path((get_global_path_from_local_path(Crashpad::crashpad_database_path).c_str()));
-    base::FilePath::StringType handler_path((get_global_crashpad_application_path().c_str()));
+    base::FilePath::StringType database_path((startup_cache.database_path.c_str()));
+    base::FilePath::StringType handler_path((startup_cache.handler_path.c_str()));
 #else
-    base::FilePath::StringType database_path(get_std_string_from_godot_string(get_global_path_from_local_path(Crashpad::crashpad_database_path)));
-    base::FilePath::StringType handler_path(get_std_string_from_godot_string(get_global_crashpad_application_path()));
+    base::FilePath::StringType database_path(CrashpadStringUtils::to_std_string(startup_cache.database_path));
+    base::FilePath::StringType handler_path(CrashpadStringUtils::to_std_string(startup_cache.handler_path));
 #endif
 
     base::FilePath db(database_path);
     base::FilePath handler(handler_path);
 
-// Database management is only on Windows and MacOS. For other platforms, we have to upload manually using CURL
+    // Only Windows and MacOS sample whole sessions, see below
+    bool uploads_enabled = true;
+
+// Database management is only on Windows and MacOS. For other platforms, we have to upload manually
 // and handle deleting the database files ourselves
 #if defined WINDOWS_ENABLED || defined OSX_ENABLED
     std::unique_ptr<crashpad::CrashReportDatabase> database = crashpad::CrashReportDatabase::Initialize(db);
@@ -72,38 +313,187 @@ void Crashpad::start_crashpad() {
     if (database == nullptr || database->GetSettings() == NULL) {
         ERR_PRINT("Could not initialize crashpad database!");
         print_line("Crashpad Error: Could not initialize crashpad database!");
-        return;
+        return false;
+    }
+    // The handler uploads by itself, so sampling and the hourly limit are decided once for the whole session
+    String session_key = itos(OS::get_singleton()->get_unix_time()) + "-" + itos(OS::get_singleton()->get_process_id()) + "-" + itos(OS::get_singleton()->get_ticks_usec());
+    uploads_enabled = CrashpadRateLimiter::is_sampled(session_key, Crashpad::crashpad_upload_sampling_percent);
+    if (uploads_enabled == true && Crashpad::crashpad_max_uploads_per_hour > 0)
+    {
+        std::vector<crashpad::CrashReportDatabase::Report> completed_reports;
+        if (database->GetCompletedReports(&completed_reports) == crashpad::CrashReportDatabase::kNoError)
+        {
+            int64_t now = OS::get_singleton()->get_unix_time();
+            int recent_uploads = 0;
+            for (size_t i = 0; i < completed_reports.size(); i++)
+            {
+                if (completed_reports[i].uploaded == true && now - (int64_t)completed_reports[i].last_upload_attempt_time < 3600)
+                {
+                    recent_uploads += 1;
+                }
+            }
+            uploads_enabled = recent_uploads < Crashpad::crashpad_max_uploads_per_hour;
+        }
     }
-    // Enable automatic uploads
+
+    // A session that was not sampled and did not exit cleanly left its crash pending. That one is skipped,
+    // the older pending reports are still uploaded.
+    String unsampled_marker_path = OS::get_singleton()->get_user_data_dir().plus_file("godot_crashpad_unsampled_session");
+    if (FileAccess::exists(unsampled_marker_path) == true)
+    {
+        FileAccess *file = FileAccess::open(unsampled_marker_path, FileAccess::READ);
+        if (file != nullptr)
+        {
+            int64_t unsampled_start_time = file->get_line().strip_edges().to_int64();
+            file->close();
+            memdelete(file);
+            std::vector<crashpad::CrashReportDatabase::Report> pending_reports;
+            if (database->GetPendingReports(&pending_reports) == crashpad::CrashReportDatabase::kNoError)
+            {
+                for (size_t i = 0; i < pending_reports.size(); i++)
+                {
+                    if ((int64_t)pending_reports[i].creation_time >= unsampled_start_time)
+                    {
+                        database->SkipReportUpload(pending_reports[i].uuid, crashpad::Metrics::CrashSkippedReason::kUploadsDisabled);
+                    }
+                }
+            }
+        }
+        DirAccess::remove_file_or_error(unsampled_marker_path);
+    }
+
+    // Turning uploads off in the database would make the handler skip every pending report, including the ones
+    // earlier sessions left for it. A session that is not sampled starts its handler without an upload URL instead,
+    // which does not touch the database, and leaves a marker so its own crash is skipped on the next launch.
     database->GetSettings()->SetUploadsEnabled(true);
+    if (uploads_enabled == false)
+    {
+        FileAccess *file = FileAccess::open(unsampled_marker_path, FileAccess::WRITE);
+        if (file != nullptr)
+        {
+            file->store_line(itos(OS::get_singleton()->get_unix_time()));
+            file->close();
+            memdelete(file);
+            crashpad_unsampled_marker_path = unsampled_marker_path;
+        }
+        print_line("Crashpad Note: Crash uploads are off for this session because of sampling or rate limits.");
+    }
 #endif
     
-    // The Backtrace URL
-    String upload_url = Crashpad::crashpad_api_URL + Crashpad::crashpad_api_token + "/minidump";
-    std::string upload_url_s = get_std_string_from_godot_string(upload_url);
+    // A benchmark child sends its crash to the benchmark's local sink instead.
+    // Not in release builds, where anyone could use these to crash the game or redirect its reports.
+    bool benchmark_crash = false;
+#ifdef DEBUG_ENABLED
+    List<String> command_line = OS::get_singleton()->get_cmdline_args();
+    for (List<String>::Element *E = command_line.front(); E; E = E->next())
+    {
+        if (E->get() == CrashpadBenchmark::CRASH_ARGUMENT)
+        {
+            benchmark_crash = true;
+        }
+        else if (E->get().begins_with(CrashpadBenchmark::URL_ARGUMENT))
+        {
+            Crashpad::crashpad_api_URL = E->get().substr(strlen(CrashpadBenchmark::URL_ARGUMENT), E->get().length());
+            Crashpad::crashpad_api_token = "";
+        }
+    }
+#endif
+
+    // The Backtrace URL. Without one, the handler only writes dumps (a session that is not sampled).
+    String upload_url = uploads_enabled == true ? Crashpad::crashpad_api_URL + Crashpad::crashpad_api_token + "/minidump" : String();
+    std::string upload_url_s = CrashpadStringUtils::to_std_string(upload_url);
 
-    // Remove upload limit for now
+    // The module does its own sampling and rate limiting (see the upload_sampling_percent and max_uploads_* settings),
+    // so the handler's fixed limit of one upload per hour is turned off
     crashpad_arguments.push_back("--no-rate-limit");
 
-    // Add annotations
-    for (int i = 0; i < crashpad_user_crash_attributes.size(); i++)
+    // Add annotations. A shared handler serves several processes, so there they are set on this process instead.
+    if (Crashpad::crashpad_shared_handler == true)
+    {
+        for (int i = 0; i < crashpad_user_crash_attributes.size(); i++)
+        {
+            CrashpadAnnotations::set((String)crashpad_user_crash_attributes.get_key_at_index(i), (String)crashpad_user_crash_attributes.get_value_at_index(i));
+        }
+        CrashpadAnnotations::set("godot_pid", itos(OS::get_singleton()->get_process_id()));
+    }
+    for (int i = 0; i < crashpad_user_crash_attributes.size() && Crashpad::crashpad_shared_handler == false; i++)
     {
         Variant key_variant = crashpad_user_crash_attributes.get_key_at_index(i);
         Variant value_variant = crashpad_user_crash_attributes.get_value_at_index(i);
         String key_string = (String)key_variant;
         String value_string = (String)value_variant;
 
-        crashpad_annotations.insert(std::pair<std::string, std::string>(get_std_string_from_godot_string(key_string), get_std_string_from_godot_string(value_string)));
+        crashpad_annotations.insert(std::pair<std::string, std::string>(CrashpadStringUtils::to_std_string(key_string), CrashpadStringUtils::to_std_string(value_string)));
     }
 
+    _register_crash_hook_annotations();
+
     // Add log file attachment?
     if (Crashpad::crashpad_upload_godot_log == true)
     {
-        // Currently not implemented for Windows or MacOS
+        if (Crashpad::crashpad_log_attachment_mode == LOG_ATTACHMENT_MEMORY_BUFFER)
+        {
+            // The buffer itself was added by start_crashpad(), on the main thread.
+            // The handler writes the dump itself, so the log tail has to be in an annotation before it does
+            if (CrashpadCrashHook::install() == true)
+            {
+                CrashpadCrashHook::add_callback(&_write_log_tail_annotation, nullptr);
+            }
+            else
+            {
 #if defined WINDOWS_ENABLED || defined OSX_ENABLED
-        WARN_PRINT("Log file attachment support not yet implemented!");
-        print_line("Crashpad Warning: Log file attachment support not yet implemented!");
+                WARN_PRINT("Log attachments are not yet supported on this platform!");
+                print_line("Crashpad Warning: Log attachments are not yet supported on this platform!");
 #endif
+            }
+        }
+        else
+        {
+            // Only the Linux upload path can attach files
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED
+            WARN_PRINT("Only the 'Memory Buffer' log attachment mode is supported on this platform!");
+            print_line("Crashpad Warning: Only the 'Memory Buffer' log attachment mode is supported on this platform!");
+#endif
+        }
+    }
+
+    // Sessions are counted even if crashes are not uploaded, so the crash rate stays right
+    if (Crashpad::crashpad_session_tracking == true)
+    {
+        crashpad_session_tracker.batch_size = Crashpad::crashpad_session_batch_size;
+        crashpad_session_tracker.set_timeouts(Crashpad::crashpad_upload_connect_timeout, Crashpad::crashpad_upload_total_timeout);
+        if (crashpad_session_tracker.start(startup_cache.database_path, Crashpad::crashpad_session_events_url, Crashpad::crashpad_user_crash_attributes) == OK)
+        {
+            CrashpadAnnotations::set("session_id", crashpad_session_tracker.get_session_id());
+            CrashpadAnnotations::set("install_id", crashpad_session_tracker.get_install_id());
+        }
+        else
+        {
+            WARN_PRINT("Could not record the session start in the crashpad database!");
+        }
+    }
+
+    // How much memory goes into the dump, read by the handler when it takes it
+    CrashpadMemoryRanges::set_dump_profile((CrashpadMemoryRanges::DumpProfile)Crashpad::crashpad_dump_profile);
+
+    // Breadcrumbs are written into an annotation right before the dump is taken
+    if (CrashpadCrashHook::install() == true)
+    {
+        CrashpadCrashHook::add_callback(&_write_breadcrumbs_annotation, nullptr);
+        // Only kept while a script debugger is active, see CrashpadScriptStack
+        if (CrashpadScriptStack::is_available() == true)
+        {
+            CrashpadCrashHook::add_callback(&_write_script_stack_annotation, nullptr);
+        }
+    }
+
+    // Non-fatal errors are collected in memory and sent in batches
+    if (Crashpad::crashpad_error_reporting == true && Crashpad::crashpad_skip_error_upload == false)
+    {
+        crashpad_error_reporter.flush_interval_sec = Crashpad::crashpad_error_flush_interval;
+        crashpad_error_reporter.max_batch_size = Crashpad::crashpad_error_max_batch_size;
+        crashpad_error_reporter.set_timeouts(Crashpad::crashpad_upload_connect_timeout, Crashpad::crashpad_upload_total_timeout);
+        crashpad_error_reporter.start(Crashpad::crashpad_api_URL + Crashpad::crashpad_api_token + "/json", Crashpad::crashpad_user_crash_attributes, Crashpad::crashpad_capture_engine_errors);
     }
 
     // Skip starting the client?
@@ -111,220 +501,793 @@ void Crashpad::start_crashpad() {
     {
         OS::get_singleton()->print("Skipped Crashpad error uploading!");
         print_line("Crashpad Note: Skipped Crashpad error uploading!");
-        return;
+        return false;
     }
 
-    crashpad_client_init = crashpad_client.StartHandler(
-        handler,
-        db,
-        db,
-        upload_url_s,
-        crashpad_annotations,
-        crashpad_arguments,
-        true,
-        true
-    );
+    bool start_own_handler = Crashpad::crashpad_shared_handler == false;
+    if (Crashpad::crashpad_shared_handler == true)
+    {
+#if defined CRASHPAD_LINUX_ENABLED
+        // A running handler cannot be shared between unrelated processes here, so none is kept running at all:
+        // the handler is only started when this process crashes, and writes into the shared database
+        crashpad_client_init = crashpad_client.StartHandlerAtCrash(
+            handler,
+            db,
+            db,
+            upload_url_s,
+            crashpad_annotations,
+            crashpad_arguments
+        );
+#else
+        // The shared handler uploads for the other processes too, so it always gets the URL
+        crashpad_client_init = connect_to_shared_handler(startup_cache.handler_path, startup_cache.database_path, Crashpad::crashpad_api_URL + Crashpad::crashpad_api_token + "/minidump");
+        if (crashpad_client_init == false)
+        {
+            // Crashes still get a dump, just from a handler of this process alone
+            WARN_PRINT("Could not connect to the shared crashpad handler! Starting one for this process only.");
+            print_line("Crashpad Warning: Could not connect to the shared crashpad handler! Starting one for this process only.");
+            start_own_handler = true;
+        }
+#endif
+    }
+    if (start_own_handler == true)
+    {
+        crashpad_client_init = crashpad_client.StartHandler(
+            handler,
+            db,
+            db,
+            upload_url_s,
+            crashpad_annotations,
+            crashpad_arguments,
+            true,
+            true
+        );
+    }
+    if (crashpad_client_init != startup_cache.last_start_ok || startup_cache_valid == false)
+    {
+        // A failed start is remembered too, so the next launch checks everything again
+        startup_cache.last_start_ok = crashpad_client_init;
+        startup_cache.save(startup_cache_path);
+    }
     if (crashpad_client_init == false) {
         ERR_PRINT("Could not initialize crashpad client!");
-        return;
+        return false;
+    }
+    // From here on crashes get a dump
+    crashpad_start_pending.clear();
+
+#if defined CRASHPAD_LINUX_ENABLED
+    // Watch the database now, so the crash handler can wait for the dump to be written instead of guessing
+    if (crashpad_dump_watcher.start(startup_cache.database_path) != OK)
+    {
+        WARN_PRINT("Could not watch the crashpad database! Crash dumps will only be uploaded if they are already written.");
+        print_line("Crashpad Warning: Could not watch the crashpad database! Crash dumps will only be uploaded if they are already written.");
+    }
+
+    // Upload what previous sessions left behind, without holding up the game
+    if (Crashpad::crashpad_linux_deferred_upload == true)
+    {
+        crashpad_upload_queue.max_attempts = Crashpad::crashpad_deferred_upload_max_attempts;
+        crashpad_upload_queue.max_requests_per_minute = Crashpad::crashpad_deferred_upload_max_requests_per_minute;
+        crashpad_upload_queue.set_max_bytes_per_second(Crashpad::crashpad_deferred_upload_max_bytes_per_second);
+        crashpad_upload_queue.set_timeouts(Crashpad::crashpad_upload_connect_timeout, Crashpad::crashpad_upload_total_timeout);
+        crashpad_upload_queue.start(&crashpad_report_index, startup_cache.database_path, Crashpad::crashpad_user_crash_attributes, &Crashpad::_upload_dump_from_queue, this);
+    }
+#endif
+
+    // Hang detection. A debugger stopping at a breakpoint would look like a hang, so not while debugging
+    // (the debugger that only keeps the script call stack never stops).
+    bool watchdog_enabled = Crashpad::crashpad_watchdog_enabled == true && (ScriptDebugger::get_singleton() == nullptr || CrashpadScriptStack::is_own_debugger() == true);
+    if (watchdog_enabled == true)
+    {
+        crashpad_watchdog.threshold_msec = Crashpad::crashpad_watchdog_hang_threshold;
+        crashpad_watchdog.start(&Crashpad::_on_hang, this);
+    }
+
+    // Recent engine monitor samples, written into an annotation right before the dump is taken
+    if (Crashpad::crashpad_telemetry_enabled == true)
+    {
+        crashpad_telemetry.start(Crashpad::crashpad_telemetry_window_size, Crashpad::crashpad_telemetry_metrics, Crashpad::crashpad_telemetry_sample_interval);
+        if (CrashpadCrashHook::install() == true)
+        {
+            CrashpadCrashHook::add_callback(&_write_telemetry_annotation, &crashpad_telemetry);
+        }
+    }
+
+    // A recent frame, read back on a slow cadence and encoded on a worker thread.
+    // Only the Linux upload path can attach files.
+    if (Crashpad::crashpad_screenshot_enabled == true)
+    {
+#if defined CRASHPAD_LINUX_ENABLED
+        crashpad_screenshot.interval_msec = Crashpad::crashpad_screenshot_interval;
+        crashpad_screenshot.max_dimension = Crashpad::crashpad_screenshot_max_dimension;
+        crashpad_screenshot.max_bytes = Crashpad::crashpad_screenshot_max_size_kb * 1024;
+        crashpad_screenshot.start();
+#else
+        WARN_PRINT("Screenshot attachments are not yet supported on this platform!");
+        print_line("Crashpad Warning: Screenshot attachments are not yet supported on this platform!");
+#endif
+    }
+
+    if (watchdog_enabled == true || crashpad_telemetry.is_running() == true || crashpad_screenshot.is_running() == true)
+    {
+        // The heartbeat, the samples and the screenshots come from internal processing, which keeps running while the tree is paused
+        // (deferred, as this can run on the start thread)
+        call_deferred("set_pause_mode", PAUSE_MODE_PROCESS);
+        call_deferred("set_process_internal", true);
     }
 
     OS::get_singleton()->print("Crashpad initialized successfully!");
     print_line("Crashpad Note: Crashpad initialized successfully!");
-    return;
+
+    if (benchmark_crash == true)
+    {
+        // Crash once the rest of the scene is ready, so the crash notification reaches this node
+        CrashpadAnnotations::set(CrashpadBenchmark::CRASH_TIME_ANNOTATION, itos(OS::get_singleton()->get_system_time_msecs()));
+        call_deferred("force_crash");
+    }
+
+    // Only happens after a crash that was too early for the handler, so the extra request is rare.
+    // It is sent from its own thread, so it holds up neither the game nor quitting (see ~Crashpad()).
+    if (FileAccess::exists(crashpad_early_crash_marker_path) == true && crashpad_early_crash_thread.is_started() == false)
+    {
+        crashpad_early_crash_thread.start(_early_crash_thread_func, this);
+    }
+    return true;
 #endif
 
     // If running on an unsupported platform, just log an error
     WARN_PRINT("Crashpad not supported on this platform!");
     print_line("Crashpad Warning: Crashpad not supported on this platform!");
-    return;
+    return false;
+
+}
+
+bool Crashpad::connect_to_shared_handler(const String &handler_path, const String &database_path, const String &upload_url)
+{
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED
+    // Every process using the same database shares one handler, unless a name is set
+    String name = Crashpad::crashpad_shared_handler_name;
+    if (name.empty() == true)
+    {
+        name = "godot-crashpad-" + database_path.md5_text().substr(0, 16);
+    }
+#if defined WINDOWS_ENABLED
+    String pipe_name = "\\\\.\\pipe\\" + name;
+    std::wstring pipe_name_w(pipe_name.c_str());
+    if (WaitNamedPipeW(pipe_name_w.c_str(), 0) == FALSE && GetLastError() == ERROR_FILE_NOT_FOUND)
+    {
+        // Nobody started it yet. It keeps running after this process exits, for the others.
+        // If another process starts one at the same time, the second handler cannot create the pipe and exits.
+        List<String> arguments;
+        arguments.push_back("--database=" + database_path);
+        arguments.push_back("--metrics-dir=" + database_path);
+        arguments.push_back("--url=" + upload_url);
+        for (size_t i = 0; i < crashpad_arguments.size(); i++)
+        {
+            arguments.push_back(String::utf8(crashpad_arguments[i].c_str()));
+        }
+        arguments.push_back("--pipe-name=" + pipe_name);
+        OS::ProcessID handler_id = 0;
+        if (OS::get_singleton()->execute(handler_path, arguments, false, &handler_id) != OK)
+        {
+            ERR_PRINT("Could not start the shared crashpad handler!");
+            return false;
+        }
 
+        // Wait for it to be ready
+        uint64_t deadline = OS::get_singleton()->get_ticks_msec() + 5000;
+        while (OS::get_singleton()->get_ticks_msec() < deadline)
+        {
+            if (WaitNamedPipeW(pipe_name_w.c_str(), 0) == TRUE || GetLastError() != ERROR_FILE_NOT_FOUND)
+            {
+                break;
+            }
+            OS::get_singleton()->delay_usec(20000);
+        }
+    }
+    return crashpad_client.SetHandlerIPCPipe(pipe_name_w);
+#else
+    // A handler started with --mach-service can only check in with a name launchd already knows about,
+    // so it is not started from here. launchd starts it on the first connection (see the README).
+    return crashpad_client.SetHandlerMachService(CrashpadStringUtils::to_std_string(name));
+#endif
+#else
+    return false;
+#endif
+}
+
+Error Crashpad::wait_for_own_dumps(int timeout_msec, Vector<String> &r_dumps)
+{
+    uint64_t deadline = OS::get_singleton()->get_ticks_msec() + timeout_msec;
+    uint32_t process_id = OS::get_singleton()->get_process_id();
+    while (true)
+    {
+        uint64_t now = OS::get_singleton()->get_ticks_msec();
+        Vector<String> completed_dumps;
+        Error error = crashpad_dump_watcher.wait_for_dump(now < deadline ? deadline - now : 0, completed_dumps);
+        for (int i = 0; i < completed_dumps.size(); i++)
+        {
+            // With a shared database, the dumps of the other processes show up too. Those are theirs to upload.
+            if (Crashpad::crashpad_shared_handler == false || CrashpadSignature::read_process_id(completed_dumps[i]) == process_id)
+            {
+                r_dumps.push_back(completed_dumps[i]);
+            }
+        }
+        // Without file names from the watcher (not Linux) we cannot tell whose dumps they were
+        if (error != OK || completed_dumps.empty() == true || r_dumps.empty() == false)
+        {
+            return error;
+        }
+    }
 }
 
 void Crashpad::_notification(int p_notification)
 {
-    // Only needed on Linux. This is because we have to upload the dump ourselves via CURL
+    if (p_notification == NOTIFICATION_INTERNAL_PROCESS)
+    {
+        crashpad_watchdog.tick();
+        if (crashpad_telemetry.is_running() == true)
+        {
+            crashpad_telemetry.sample();
+        }
+        if (crashpad_screenshot.is_running() == true)
+        {
+            crashpad_screenshot.poll(this);
+        }
+        return;
+    }
+    if (p_notification == MainLoop::NOTIFICATION_CRASH && crashpad_start_pending.is_set())
+    {
+        // The handler is not armed yet, so there will be no dump. Leave a marker for the next launch instead.
+        write_early_crash_marker();
+        return;
+    }
+
+    // Only needed on Linux. This is because we have to upload the dump ourselves
     // as there is not any database manager for Linux with Crashpad currently.
-#if defined X11_ENABLED
+#if defined CRASHPAD_LINUX_ENABLED
     if (p_notification == NOTIFICATION_READY)
     {
+        // With deferred uploads, the leftovers belong to the upload queue.
+        // A shared database also has the dumps of other processes, which are not ours to delete.
+        if (Crashpad::crashpad_linux_deferred_upload == true || Crashpad::crashpad_shared_handler == true)
+        {
+            return;
+        }
+
+        crashpad_report_index.lock();
+        if (crashpad_report_index.is_open() == false)
+        {
+            open_report_index();
+        }
+
         if (Crashpad::crashpad_linux_delete_crashpad_database_data_on_start == true)
         {
-            // Get all the dump files
-            Array file_dump_search_results = get_directory_contents(get_global_path_from_local_path(Crashpad::crashpad_database_path), ".dmp");
-            if (file_dump_search_results.empty() == false)
+            // Delete all the dumps and their meta files, not only the pending ones the index knows about
+            crashpad_report_index.remove_all_reports();
+            crashpad_report_index.save();
+        }
+        crashpad_report_index.unlock();
+    }
+    else if (p_notification == MainLoop::NOTIFICATION_CRASH) {
+        // The error reporter unhooks itself first, so the print below does not reach it
+        crashpad_error_reporter.request_stop();
+		ERR_PRINT("Notification of crash found!");
+
+        // Stop uploading leftovers, the new crash is more important
+        crashpad_upload_queue.request_stop();
+        crashpad_session_tracker.request_stop();
+        // Uploading takes a while and the main loop does not tick meanwhile, which is not a hang
+        crashpad_watchdog.request_stop();
+        crashpad_hang_uploader.cancel();
+
+        // Wait for Crashpad to finish writing the dump.
+        // Crashpad on Linux doesn't automatically send the crash, so we have to do it manually.
+        // A hang report may be using the watcher. It lets go of it within the same timeout, so wait for it
+        // without blocking (the hang thread could be the one that crashed), and look at the database if it never does.
+        Vector<String> completed_dumps;
+        uint64_t dump_deadline = OS::get_singleton()->get_ticks_msec() + Crashpad::crashpad_linux_dump_wait_timeout;
+        bool watcher_locked = crashpad_dump_watcher_mutex.try_lock() == OK;
+        while (watcher_locked == false && OS::get_singleton()->get_ticks_msec() < dump_deadline)
+        {
+            OS::get_singleton()->delay_usec(1000);
+            watcher_locked = crashpad_dump_watcher_mutex.try_lock() == OK;
+        }
+        if (watcher_locked == true)
+        {
+            if (crashpad_dump_watcher.is_watching() == true)
             {
-                // Delete the dumps
-                Array file_search_files = (Array)file_dump_search_results.get(0);
-                for (int i = 0; i < file_search_files.size(); i++)
+                uint64_t now = OS::get_singleton()->get_ticks_msec();
+                if (wait_for_own_dumps(now < dump_deadline ? dump_deadline - now : 0, completed_dumps) != OK)
                 {
-                    DirAccess::remove_file_or_error(file_search_files[i]);
+                    ERR_PRINT("Timed out waiting for Crashpad to write the crash dump!");
                 }
+                crashpad_dump_watcher.stop();
+            }
+            crashpad_dump_watcher_mutex.unlock();
+        }
+
+        // All the dumps share one uploader, so they go through a single kept-alive connection
+        crashpad_uploader.connect_timeout_msec = Crashpad::crashpad_upload_connect_timeout;
+        crashpad_uploader.total_timeout_msec = Crashpad::crashpad_upload_total_timeout;
+        // Pending reports of other processes in a shared database are left to them
+        upload_new_dumps(crashpad_uploader, completed_dumps, Crashpad::crashpad_user_crash_attributes, Crashpad::crashpad_shared_handler == false);
+	}
+#endif
+}
+
+void Crashpad::upload_new_dumps(CrashpadUploader &uploader, const Vector<String> &dumps, const Dictionary &attributes, bool upload_all_pending)
+{
+    // The upload worker may hold the index (or be the thread that crashed), so never block on it
+    bool index_locked = crashpad_report_index.try_lock() == OK;
+    uint64_t lock_deadline = OS::get_singleton()->get_ticks_msec() + 200;
+    while (index_locked == false && OS::get_singleton()->get_ticks_msec() < lock_deadline)
+    {
+        OS::get_singleton()->delay_usec(1000);
+        index_locked = crashpad_report_index.try_lock() == OK;
+    }
+    if (index_locked == false)
+    {
+        for (int i = 0; i < dumps.size(); i++)
+        {
+            upload_dump(uploader, dumps[i], attributes, true);
+        }
+        uploader.close();
+        return;
+    }
+
+    if (crashpad_report_index.is_open() == false)
+    {
+        open_report_index();
+    }
+    if (dumps.empty() == true && upload_all_pending == true)
+    {
+        // We don't know which dumps are new, so look at the database once
+        crashpad_report_index.reconcile(true);
+    }
+    Vector<String> new_report_ids;
+    for (int i = 0; i < dumps.size(); i++)
+    {
+        crashpad_report_index.add_report(dumps[i]);
+        new_report_ids.push_back(CrashpadReportIndex::get_report_id_from_path(dumps[i]));
+    }
+    Vector<String> report_ids = new_report_ids;
+    if (upload_all_pending == true)
+    {
+        report_ids = crashpad_report_index.get_report_ids(CrashpadReportIndex::REPORT_STATE_PENDING);
+    }
+
+    for (int i = 0; i < report_ids.size(); i++)
+    {
+        CrashpadReportIndex::Report report = crashpad_report_index.get_report(report_ids[i]);
+        crashpad_report_index.increment_report_attempts(report.id);
+        // The log, breadcrumbs and so on are of this session, older reports are sent without them.
+        // Dumps found in the database instead of by the watcher are told apart by the process that wrote them.
+        bool include_session_data = new_report_ids.find(report.id) != -1;
+        if (include_session_data == false && dumps.empty() == true)
+        {
+            include_session_data = CrashpadSignature::read_process_id(report.path) == OS::get_singleton()->get_process_id();
+        }
+        if (upload_dump(uploader, report.path, attributes, include_session_data) == OK)
+        {
+            crashpad_report_index.set_report_state(report.id, CrashpadReportIndex::REPORT_STATE_UPLOADED);
+        }
+        else
+        {
+            crashpad_report_index.set_report_state(report.id, CrashpadReportIndex::REPORT_STATE_FAILED);
+        }
+    }
+    uploader.close();
+    crashpad_report_index.save();
+    crashpad_report_index.unlock();
+}
+
+void Crashpad::_on_hang(void *p_userdata, uint64_t p_hang_msec)
+{
+    ((Crashpad *)p_userdata)->report_hang(p_hang_msec);
+}
+
+void Crashpad::report_hang(uint64_t hang_msec)
+{
+    // Runs on the watchdog thread while the main thread is stuck
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+    print_line("Crashpad Warning: The main loop has not ticked for " + itos(hang_msec) + " msec, reporting a hang.");
+
+    // The dump has every thread, the main thread shows where the game is stuck.
+    // The annotations tell it apart from a crash, the handler reads them while taking the dump.
+    CrashpadAnnotations::set("godot_hang", "true");
+    CrashpadAnnotations::set("godot_hang_duration_msec", itos(hang_msec));
+    CRASHPAD_SIMULATE_CRASH();
+    CrashpadAnnotations::remove("godot_hang");
+    CrashpadAnnotations::remove("godot_hang_duration_msec");
+
+#if defined CRASHPAD_LINUX_ENABLED
+    // Here the dump is uploaded by us, like a crash
+    Vector<String> completed_dumps;
+    crashpad_dump_watcher_mutex.lock();
+    if (crashpad_dump_watcher.is_watching() == true)
+    {
+        wait_for_own_dumps(Crashpad::crashpad_linux_dump_wait_timeout, completed_dumps);
+    }
+    crashpad_dump_watcher_mutex.unlock();
+    if (completed_dumps.empty() == true)
+    {
+        print_line("Crashpad Warning: Timed out waiting for Crashpad to write the hang dump!");
+        return;
+    }
+
+    Dictionary hang_attributes = Crashpad::crashpad_user_crash_attributes.duplicate();
+    hang_attributes["godot_hang"] = "true";
+    hang_attributes["godot_hang_duration_msec"] = itos(hang_msec);
+    crashpad_hang_uploader.connect_timeout_msec = Crashpad::crashpad_upload_connect_timeout;
+    crashpad_hang_uploader.total_timeout_msec = Crashpad::crashpad_upload_total_timeout;
+    upload_new_dumps(crashpad_hang_uploader, completed_dumps, hang_attributes, false);
+#endif
+#endif
+}
+
+void Crashpad::start_log_buffer()
+{
+    if (Crashpad::crashpad_log_buffer != nullptr)
+    {
+        return;
+    }
+    // The OS owns its loggers and frees them on exit
+    Crashpad::crashpad_log_buffer = memnew(CrashpadLogBuffer(MAX(Crashpad::crashpad_log_tail_size_kb, 1) * 1024));
+    OS::get_singleton()->add_logger(Crashpad::crashpad_log_buffer);
+}
+
+void Crashpad::open_report_index()
+{
+    String database_path = get_global_path_from_local_path(Crashpad::crashpad_database_path);
+    crashpad_report_index.open(database_path);
+    // Only lists the database if the handler added or removed reports since the index was saved
+    crashpad_report_index.reconcile();
+}
+
+Error Crashpad::_upload_dump_from_queue(void *p_userdata, CrashpadUploader &p_uploader, const String &p_dump_path, const Dictionary &p_attributes)
+{
+    Crashpad *self = (Crashpad *)p_userdata;
+    // The current log belongs to this session, not to the one that crashed
+    return self->upload_dump(p_uploader, p_dump_path, p_attributes, false);
+}
+
+Error Crashpad::upload_dump(CrashpadUploader &uploader, String dump_path, const Dictionary &attributes, bool include_session_data)
+{
+    // Crashes this install already sent recently only upload a small record instead of the dump (optional)
+    // Hang dumps are taken from the watchdog thread, so their crashing thread is always the same and says nothing
+    CrashpadSignature signature;
+    bool needs_signature = (Crashpad::crashpad_dedupe_window_hours > 0 || Crashpad::crashpad_max_uploads_per_signature_per_day > 0) && attributes.has("godot_hang") == false;
+    bool has_signature = needs_signature == true && signature.parse(dump_path, Crashpad::crashpad_dedupe_stack_frames) == OK;
+
+    // Reports dropped by sampling or rate limits count as done, so they are not retried
+    if (check_rate_limit(dump_path, has_signature ? signature.hash : String()) == false)
+    {
+        print_line("Crashpad Note: Crash dump was not uploaded because of sampling or rate limits: " + dump_path);
+        return OK;
+    }
+
+    uint32_t duplicate_count = 0;
+    if (has_signature == true && Crashpad::crashpad_dedupe_window_hours > 0 && check_signature(signature, duplicate_count) == true)
+    {
+        Error record_error = upload_duplicate_record(uploader, dump_path, signature, duplicate_count, attributes);
+        if (record_error == OK)
+        {
+            record_upload(signature.hash);
+        }
+        return record_error;
+    }
+
+    CrashpadMultipartBody body;
+
+    // Upload arguments
+    for (int i = 0; i < attributes.size(); i++)
+    {
+        Variant key = attributes.get_key_at_index(i);
+        Variant value = attributes.get_value_at_index(i);
+        body.add_field((String)key, (String)value);
+    }
+    if (has_signature == true)
+    {
+        body.add_field("godot_crash_signature", signature.hash);
+    }
+
+    // Upload Minidump (setup)
+    Error error = body.add_file("upload_file_minidump", dump_path, "application/octet-stream");
+    if (error != OK)
+    {
+        ERR_PRINT("Cannot open crash dump for uploading: " + dump_path);
+        return error;
+    }
+
+    // Upload log file (optional)
+    if (include_session_data == true && Crashpad::crashpad_log_attachment_mode == LOG_ATTACHMENT_MEMORY_BUFFER)
+    {
+        if (Crashpad::crashpad_log_buffer != nullptr)
+        {
+            int max_bytes = Crashpad::crashpad_log_tail_size_kb * 1024;
+            CharString log_tail;
+            log_tail.resize(max_bytes + 1);
+            int length = Crashpad::crashpad_log_buffer->copy_tail(log_tail.ptrw(), max_bytes, Crashpad::crashpad_log_tail_lines);
+            log_tail.resize(length + 1);
+            log_tail.ptrw()[length] = '\0';
+            body.add_file_data("godot_log.log", "godot_log.log", "application/text", log_tail);
+        }
+    }
+    else if (include_session_data == true)
+    {
+        ProjectSettings* project_singleton = ProjectSettings::get_singleton();
+        Variant project_setting_logging_enabled = project_singleton->get_setting("logging/file_logging/enable_file_logging");
+        if (project_setting_logging_enabled.get_type() == project_setting_logging_enabled.BOOL && (bool)project_setting_logging_enabled == true) {
+            Variant logging_filepath = project_singleton->get_setting("logging/file_logging/log_path");
+            String logging_filepath_string = (String)logging_filepath;
+            String log_filepath = project_singleton->globalize_path(logging_filepath_string);
+
+            // Upload log (either all of it, or only the end of it)
+            Error log_error = ERR_FILE_CANT_OPEN;
+            if (Crashpad::crashpad_log_attachment_mode == LOG_ATTACHMENT_FILE_TAIL)
+            {
+                uint64_t tail_offset = 0;
+                uint64_t tail_length = 0;
+                log_error = CrashpadLogBuffer::find_file_tail(log_filepath, (uint64_t)Crashpad::crashpad_log_tail_size_kb * 1024, Crashpad::crashpad_log_tail_lines, tail_offset, tail_length);
+                if (log_error == OK)
+                {
+                    log_error = body.add_file_range("godot_log.log", log_filepath, "application/text", tail_offset, tail_length);
+                }
+            }
+            else
+            {
+                log_error = body.add_file("godot_log.log", log_filepath, "application/text");
             }
-            // Get all the meta files
-            Array file_meta_search_results = get_directory_contents(get_global_path_from_local_path(Crashpad::crashpad_database_path), ".meta");
-            if (file_meta_search_results.empty() == false)
+            if (log_error != OK)
             {
-                // Delete the meta
-                Array file_search_files = (Array)file_meta_search_results.get(0);
-                for (int i = 0; i < file_search_files.size(); i++)
-                {
-                    DirAccess::remove_file_or_error(file_search_files[i]);
-                }
+                WARN_PRINT("Cannot open Godot log file for uploading: " + log_filepath);
             }
         }
     }
-    else if (p_notification == MainLoop::NOTIFICATION_CRASH) {
-		ERR_PRINT("Notification of crash found!");
 
-        // Sleep - so Crashpad can generate the dump
-        // Not ideal, but Crashpad on Linux doesn't automatically send the crash, so we have to do it manually
-        // using CURL.
-        // Credit for snippet: https://stackoverflow.com/questions/4184468/sleep-for-milliseconds
-        std::this_thread::sleep_for(std::chrono::microseconds(2000));
+    // Breadcrumbs and live annotations belong to this session too, so only with the crash that just happened
+    if (include_session_data == true)
+    {
+        Dictionary live_annotations = CrashpadAnnotations::get_all();
+        for (int i = 0; i < live_annotations.size(); i++)
+        {
+            body.add_field((String)live_annotations.get_key_at_index(i), (String)live_annotations.get_value_at_index(i));
+        }
 
-        // Get all the dump files
-        Array file_search_results = get_directory_contents(get_global_path_from_local_path(Crashpad::crashpad_database_path), ".dmp");
-        // Was there an error?
-        if (file_search_results.empty() == true)
+        CharString breadcrumbs;
+        breadcrumbs.resize(CrashpadBreadcrumbs::CAPACITY * (CrashpadBreadcrumbs::CATEGORY_SIZE + CrashpadBreadcrumbs::MESSAGE_SIZE + 32) + 1);
+        // Can run on the hang thread while the crash hook writes the annotation, so it has its own scratch
+        Vector<CrashpadBreadcrumbs::Snapshot> breadcrumb_snapshots;
+        breadcrumb_snapshots.resize(CrashpadBreadcrumbs::CAPACITY);
+        int length = CrashpadBreadcrumbs::write_text(breadcrumbs.ptrw(), breadcrumbs.size() - 1, breadcrumb_snapshots.ptrw());
+        if (length > 0)
         {
-            return;
+            breadcrumbs.resize(length + 1);
+            breadcrumbs.ptrw()[length] = '\0';
+            body.add_file_data("breadcrumbs.log", "breadcrumbs.log", "application/text", breadcrumbs);
         }
 
-        Array file_search_files = (Array)file_search_results.get(0);
+        if (crashpad_telemetry.is_running() == true)
+        {
+            CharString telemetry;
+            telemetry.resize(crashpad_telemetry.get_max_csv_size() + 1);
+            int telemetry_length = crashpad_telemetry.write_csv(telemetry.ptrw(), telemetry.size() - 1);
+            telemetry.resize(telemetry_length + 1);
+            telemetry.ptrw()[telemetry_length] = '\0';
+            body.add_file_data("telemetry.csv", "telemetry.csv", "text/csv", telemetry);
+        }
 
-        for (int i = 0; i < file_search_files.size(); i++)
+        if (CrashpadScriptStack::is_available() == true)
         {
-            upload_dump_through_curl((String)file_search_files[i]);
+            CharString script_stack;
+            script_stack.resize(CrashpadScriptStack::MAX_TEXT_SIZE);
+            int script_stack_length = CrashpadScriptStack::write_text(script_stack.ptrw(), script_stack.size() - 1);
+            if (script_stack_length > 0)
+            {
+                script_stack.resize(script_stack_length + 1);
+                script_stack.ptrw()[script_stack_length] = '\0';
+                body.add_file_data("script_stack.log", "script_stack.log", "application/text", script_stack);
+            }
         }
-	}
-#endif
+
+        CharString screenshot;
+        if (crashpad_screenshot.copy_latest(screenshot) == true)
+        {
+            body.add_file_data("screenshot.png", "screenshot.png", "image/png", screenshot);
+        }
+    }
+    body.finish();
+
+    // Compress the whole request (optional). Small reports are not worth the extra pass over the files.
+    CrashpadCompression::Mode compression_mode = (CrashpadCompression::Mode)Crashpad::crashpad_upload_compression;
+    CrashpadFileBody compressed_body;
+    CrashpadUploadBody *upload_body = &body;
+    Vector<String> headers;
+    // Next to the dump, so it is deleted with it even if this process dies mid-upload (see CrashpadReportIndex)
+    String compressed_path = dump_path.get_basename() + ".upload";
+    if (compression_mode != CrashpadCompression::MODE_NONE && body.get_size() >= (uint64_t)Crashpad::crashpad_upload_compression_threshold)
+    {
+        if (CrashpadCompression::compress_to_file(&body, compressed_path, compression_mode) == OK && compressed_body.set_file(compressed_path, body.get_content_type()) == OK)
+        {
+            upload_body = &compressed_body;
+            headers.push_back("Content-Encoding: " + CrashpadCompression::get_content_encoding(compression_mode));
+        }
+        else
+        {
+            WARN_PRINT("Could not compress crash dump, uploading it uncompressed.");
+        }
+    }
+
+    // Uploading the actual Minidump
+    error = post_report(uploader, Crashpad::crashpad_api_URL + Crashpad::crashpad_api_token + "/minidump", upload_body, headers);
+    if (upload_body == &compressed_body)
+    {
+        DirAccess::remove_file_or_error(compressed_path);
+    }
+    if (error == OK)
+    {
+        if (has_signature == true && Crashpad::crashpad_dedupe_window_hours > 0)
+        {
+            record_signature(signature);
+        }
+        record_upload(has_signature ? signature.hash : String());
+    }
+    return error;
 }
 
-#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined X11_ENABLED
-std::string Crashpad::get_std_string_from_godot_string(String input)
+bool Crashpad::check_rate_limit(const String &dump_path, const String &signature_hash)
 {
-    // Credit: https://godotengine.org/qa/18552/gdnative-convert-godot-string-to-const-char
-    std::wstring input_ws = input.c_str();
-    return std::string(input_ws.begin(), input_ws.end());
+    if (CrashpadRateLimiter::is_sampled(CrashpadReportIndex::get_report_id_from_path(dump_path), Crashpad::crashpad_upload_sampling_percent) == false)
+    {
+        return false;
+    }
+    if (Crashpad::crashpad_max_uploads_per_hour <= 0 && Crashpad::crashpad_max_uploads_per_signature_per_day <= 0)
+    {
+        return true;
+    }
+
+    // This can run while crashing, so if the history is busy the report is let through
+    if (crashpad_rate_limiter.try_lock() != OK)
+    {
+        return true;
+    }
+    if (crashpad_rate_limiter.is_open() == false)
+    {
+        crashpad_rate_limiter.open(get_global_path_from_local_path(Crashpad::crashpad_database_path));
+    }
+    crashpad_rate_limiter.max_uploads_per_hour = Crashpad::crashpad_max_uploads_per_hour;
+    crashpad_rate_limiter.max_uploads_per_signature_per_day = Crashpad::crashpad_max_uploads_per_signature_per_day;
+    bool allowed = crashpad_rate_limiter.can_upload(signature_hash);
+    crashpad_rate_limiter.unlock();
+    return allowed;
 }
-#endif
 
-Array Crashpad::get_directory_contents(String root_directory_path, String desired_extension)
+void Crashpad::record_upload(const String &signature_hash)
 {
-    Array files;
-    Array directories;
-    if (root_directory_path.ends_with("//"))
+    if (Crashpad::crashpad_max_uploads_per_hour <= 0 && Crashpad::crashpad_max_uploads_per_signature_per_day <= 0)
     {
-        root_directory_path.remove(root_directory_path.size()-1);
-        root_directory_path.remove(root_directory_path.size()-1);
+        return;
     }
-    else if (root_directory_path.ends_with("/"))
+    if (crashpad_rate_limiter.try_lock() != OK)
     {
-        root_directory_path.remove(root_directory_path.size()-1);
+        return;
     }
-    DirAccess *dir_link = DirAccess::open(root_directory_path);
-    
-    Error error = dir_link->list_dir_begin();
-    if (error == Error::ERR_CANT_OPEN)
+    if (crashpad_rate_limiter.is_open() == false)
     {
-        ERR_PRINT("Cannot open Crashpad database folder! Cannot upload crash log automatically");
-        return files;
+        crashpad_rate_limiter.open(get_global_path_from_local_path(Crashpad::crashpad_database_path));
     }
-
-    _add_directory_contents(dir_link, files, directories, desired_extension);
-    
-    Array return_value;
-    return_value.append(files);
-    return_value.append(directories);
-    return return_value;
+    crashpad_rate_limiter.record_upload(signature_hash);
+    crashpad_rate_limiter.save();
+    crashpad_rate_limiter.unlock();
 }
-void Crashpad::_add_directory_contents(DirAccess *dir, Array files, Array directories, String desired_extension)
-{
-    String filename = dir->get_next();
 
-    while (filename != "")
+Error Crashpad::post_report(CrashpadUploader &uploader, const String &url, CrashpadUploadBody *body, const Vector<String> &headers)
+{
+    int response_code = 0;
+    Error error = uploader.post(url, body, headers, response_code);
+    if (error != OK)
     {
-        if (filename == "." || filename == "..")
-        {
-            filename = dir->get_next();
-        }
-        else
-        {
-            String path = dir->get_current_dir() + "/" + filename;
-            if (dir->current_is_dir())
-            {
-                DirAccess *sub_dir_link = DirAccess::open(path);
-                sub_dir_link->list_dir_begin();
-                directories.append(path);
-                _add_directory_contents(sub_dir_link, files, directories, desired_extension);
-            }
-            else
-            {
-                if (path.ends_with(desired_extension))
-                {
-                    files.append(path);
-                }
-            }
-            filename = dir->get_next();
-        }
+        ERR_PRINT("Could not upload crash dump! Error code: " + itos(error));
+        print_line("Crashpad Error: Could not upload crash dump! Error code: " + itos(error));
+        return error;
+    }
+    if (response_code < 200 || response_code >= 300)
+    {
+        ERR_PRINT("Crash dump upload was rejected by the server! Response code: " + itos(response_code));
+        print_line("Crashpad Error: Crash dump upload was rejected by the server! Response code: " + itos(response_code));
+        return ERR_QUERY_FAILED;
     }
-    dir->list_dir_end();
+    return OK;
 }
 
-void Crashpad::upload_dump_through_curl(String dump_path)
+bool Crashpad::check_signature(const CrashpadSignature &signature, uint32_t &r_duplicate_count)
 {
-    List<String> arguments;
-
-    // Start uploading using CURL
-    arguments.push_back("-v");
-    
-    // Upload arguments
-    for (int i = 0; i < Crashpad::crashpad_user_crash_attributes.size(); i++)
+    // This can run while crashing, so if the cache is busy the dump is simply sent in full
+    if (crashpad_signature_cache.try_lock() != OK)
     {
-        Variant key = Crashpad::crashpad_user_crash_attributes.get_key_at_index(i);
-        Variant value = Crashpad::crashpad_user_crash_attributes.get_value_at_index(i);
-        String key_string = (String)key;
-        String value_string = (String)value;
-
-        arguments.push_back("-F");
-        arguments.push_back(key_string + "=" + value_string);
+        return false;
+    }
+    if (crashpad_signature_cache.is_open() == false)
+    {
+        crashpad_signature_cache.open(get_global_path_from_local_path(Crashpad::crashpad_database_path));
     }
 
-    // Upload Minidump (setup)
-    arguments.push_back("-F");
-    arguments.push_back("upload_file_minidump=@" + String(dump_path));
-    arguments.push_back("-H");
-    arguments.push_back("Expect: gzip");
+    uint64_t window_sec = (uint64_t)Crashpad::crashpad_dedupe_window_hours * 3600;
+    bool duplicate = crashpad_signature_cache.is_recently_reported(signature.hash, window_sec);
+    if (duplicate == true)
+    {
+        r_duplicate_count = crashpad_signature_cache.record_duplicate(signature.hash);
+        crashpad_signature_cache.save(window_sec);
+    }
+    crashpad_signature_cache.unlock();
+    return duplicate;
+}
 
-    // Upload log file (optional)
-    ProjectSettings* project_singleton = ProjectSettings::get_singleton();
-    Variant project_setting_logging_enabled = project_singleton->get_setting("logging/file_logging/enable_file_logging");
-    if (project_setting_logging_enabled.get_type() == project_setting_logging_enabled.BOOL && (bool)project_setting_logging_enabled == true) {
-        Variant logging_filepath = project_singleton->get_setting("logging/file_logging/log_path");
-        String logging_filepath_string = (String)logging_filepath;
-        String log_filepath = project_singleton->globalize_path(logging_filepath_string);
-
-        // Upload log
-        arguments.push_back("-F");
-        arguments.push_back("godot_log.log=@" + log_filepath + "; type=application/text");
-        arguments.push_back(Crashpad::crashpad_api_URL + Crashpad::crashpad_api_token + "/minidump");
+void Crashpad::record_signature(const CrashpadSignature &signature)
+{
+    if (crashpad_signature_cache.try_lock() != OK)
+    {
+        return;
     }
-    
-    // Uploading the actual Minidump
-    arguments.push_back(Crashpad::crashpad_api_URL + Crashpad::crashpad_api_token + "/minidump");
+    if (crashpad_signature_cache.is_open() == false)
+    {
+        crashpad_signature_cache.open(get_global_path_from_local_path(Crashpad::crashpad_database_path));
+    }
+    crashpad_signature_cache.record_report(signature.hash);
+    crashpad_signature_cache.save((uint64_t)Crashpad::crashpad_dedupe_window_hours * 3600);
+    crashpad_signature_cache.unlock();
+}
 
-    // Calling it on CURL
-    OS::get_singleton()->execute("curl", arguments);
+Error Crashpad::upload_duplicate_record(CrashpadUploader &uploader, String dump_path, const CrashpadSignature &signature, uint32_t duplicate_count, const Dictionary &attributes)
+{
+    // A Backtrace JSON report with the signature frames instead of the minidump
+    Array stack;
+    for (int i = 0; i < signature.frames.size(); i++)
+    {
+        Dictionary frame;
+        frame["funcName"] = signature.frames[i];
+        stack.push_back(frame);
+    }
+    Dictionary thread;
+    thread["name"] = "crashed";
+    thread["fault"] = true;
+    thread["stack"] = stack;
+    Dictionary threads;
+    threads["crashed"] = thread;
+
+    Dictionary record_attributes = attributes.duplicate();
+    record_attributes["godot_crash_signature"] = signature.hash;
+    record_attributes["godot_duplicate_count"] = duplicate_count;
+    record_attributes["godot_exception_code"] = "0x" + String::num_uint64(signature.exception_code, 16);
+
+    Dictionary record;
+    record["uuid"] = CrashpadReportIndex::get_report_id_from_path(dump_path);
+    record["timestamp"] = OS::get_singleton()->get_unix_time();
+    record["lang"] = "c++";
+    record["langVersion"] = "";
+    record["agent"] = "godot-crashpad";
+    record["agentVersion"] = "1.0";
+    record["mainThread"] = "crashed";
+    record["threads"] = threads;
+    record["attributes"] = record_attributes;
+
+    CrashpadMemoryBody body;
+    body.set_data(JSON::print(record).utf8(), "application/json");
+    return post_report(uploader, Crashpad::crashpad_api_URL + Crashpad::crashpad_api_token + "/json", &body, Vector<String>());
+}
 
-    // For debugging only: See what is being passed to CURL
-    /*
-    String output_test = "curl ";
-    for (int i = 0; i < arguments.size(); i++) {
-        output_test += " " + arguments[i];
+void Crashpad::set_default_paths()
+{
+    if (Crashpad::crashpad_application_path.empty() == true)
+    {
+        Crashpad::crashpad_application_path = "res://crashpad_handler.exe";
+    }
+    if (Crashpad::crashpad_database_path.empty() == true)
+    {
+        Crashpad::crashpad_database_path = "res://Crashpad/db/";
     }
-    print_line(output_test);
-    */
 }
 
 bool Crashpad::check_for_crashpad_application()
@@ -360,7 +1323,7 @@ String Crashpad::get_global_crashpad_application_path()
         actual_path = get_global_path_from_local_path(Crashpad::crashpad_application_path);
 #endif
 
-#ifdef X11_ENABLED
+#ifdef CRASHPAD_LINUX_ENABLED
         // The default extension is nothing, just the file name
         actual_path = get_global_path_from_local_path(Crashpad::crashpad_application_path);
 #endif
@@ -416,6 +1379,19 @@ bool Crashpad::check_for_crashpad_database(bool make_if_not_exist)
 void Crashpad::_bind_methods() {
     ClassDB::bind_method(D_METHOD("start_crashpad"), &Crashpad::start_crashpad);
     ClassDB::bind_method(D_METHOD("force_crash"), &Crashpad::force_crash);
+    ClassDB::bind_method(D_METHOD("add_breadcrumb", "category", "message"), &Crashpad::add_breadcrumb);
+    ClassDB::bind_method(D_METHOD("clear_breadcrumbs"), &Crashpad::clear_breadcrumbs);
+    ClassDB::bind_method(D_METHOD("set_annotation", "key", "value"), &Crashpad::set_annotation);
+    ClassDB::bind_method(D_METHOD("remove_annotation", "key"), &Crashpad::remove_annotation);
+    ClassDB::bind_method(D_METHOD("clear_annotations"), &Crashpad::clear_annotations);
+    ClassDB::bind_method(D_METHOD("report_error", "message", "attributes"), &Crashpad::report_error, DEFVAL(Dictionary()));
+    ClassDB::bind_method(D_METHOD("add_memory_block", "key", "data"), &Crashpad::add_memory_block);
+    ClassDB::bind_method(D_METHOD("remove_memory_block", "key"), &Crashpad::remove_memory_block);
+    ClassDB::bind_method(D_METHOD("clear_memory_blocks"), &Crashpad::clear_memory_blocks);
+    ClassDB::bind_method(D_METHOD("run_benchmark", "options"), &Crashpad::run_benchmark, DEFVAL(Dictionary()));
+    ClassDB::bind_method(D_METHOD("capture_screenshot"), &Crashpad::capture_screenshot);
+
+    ADD_SIGNAL(MethodInfo("crashpad_started", PropertyInfo(Variant::BOOL, "success")));
 
     // Crashpad setup variables
     // =====
@@ -431,6 +1407,15 @@ void Crashpad::_bind_methods() {
     ClassDB::bind_method(D_METHOD("set_database_path", "new_path"), &Crashpad::set_crashpad_database_path);
 	ClassDB::bind_method(D_METHOD("get_database_path"), &Crashpad::get_crashpad_database_path);
     ADD_PROPERTY(PropertyInfo(Variant::STRING, "crashpad_settings/database_path", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_database_path", "get_database_path");
+    ClassDB::bind_method(D_METHOD("set_async_start", "async_start"), &Crashpad::set_crashpad_async_start);
+	ClassDB::bind_method(D_METHOD("get_async_start"), &Crashpad::get_crashpad_async_start);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "crashpad_settings/async_start", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_async_start", "get_async_start");
+    ClassDB::bind_method(D_METHOD("set_shared_handler", "shared_handler"), &Crashpad::set_crashpad_shared_handler);
+	ClassDB::bind_method(D_METHOD("get_shared_handler"), &Crashpad::get_crashpad_shared_handler);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "crashpad_settings/shared_handler", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_shared_handler", "get_shared_handler");
+    ClassDB::bind_method(D_METHOD("set_shared_handler_name", "name"), &Crashpad::set_crashpad_shared_handler_name);
+	ClassDB::bind_method(D_METHOD("get_shared_handler_name"), &Crashpad::get_crashpad_shared_handler_name);
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "crashpad_settings/shared_handler_name", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_shared_handler_name", "get_shared_handler_name");
     
     ClassDB::bind_method(D_METHOD("set_use_manual_application_extension", "use_manual_extension"), &Crashpad::set_crashpad_use_manual_application_extension);
 	ClassDB::bind_method(D_METHOD("get_use_manual_application_extension"), &Crashpad::get_crashpad_use_manual_application_extension);
@@ -438,6 +1423,56 @@ void Crashpad::_bind_methods() {
     ClassDB::bind_method(D_METHOD("set_manual_application_extension", "manual_extension"), &Crashpad::set_crashpad_manual_application_extension);
 	ClassDB::bind_method(D_METHOD("get_manual_application_extension"), &Crashpad::get_crashpad_manual_application_extension);
     ADD_PROPERTY(PropertyInfo(Variant::STRING, "crashpad_settings/manual_application_extension", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_manual_application_extension", "get_manual_application_extension");
+
+    ClassDB::bind_method(D_METHOD("set_upload_connect_timeout", "timeout_msec"), &Crashpad::set_crashpad_upload_connect_timeout);
+	ClassDB::bind_method(D_METHOD("get_upload_connect_timeout"), &Crashpad::get_crashpad_upload_connect_timeout);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "crashpad_settings/upload_connect_timeout_msec", PROPERTY_HINT_RANGE, "100,60000,1", PROPERTY_USAGE_DEFAULT_INTL), "set_upload_connect_timeout", "get_upload_connect_timeout");
+    ClassDB::bind_method(D_METHOD("set_upload_total_timeout", "timeout_msec"), &Crashpad::set_crashpad_upload_total_timeout);
+	ClassDB::bind_method(D_METHOD("get_upload_total_timeout"), &Crashpad::get_crashpad_upload_total_timeout);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "crashpad_settings/upload_total_timeout_msec", PROPERTY_HINT_RANGE, "100,600000,1", PROPERTY_USAGE_DEFAULT_INTL), "set_upload_total_timeout", "get_upload_total_timeout");
+    ClassDB::bind_method(D_METHOD("set_upload_compression", "compression"), &Crashpad::set_crashpad_upload_compression);
+	ClassDB::bind_method(D_METHOD("get_upload_compression"), &Crashpad::get_crashpad_upload_compression);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "crashpad_settings/upload_compression", PROPERTY_HINT_ENUM, "None,Gzip,Zstd", PROPERTY_USAGE_DEFAULT_INTL), "set_upload_compression", "get_upload_compression");
+    ClassDB::bind_method(D_METHOD("set_upload_compression_threshold", "threshold_bytes"), &Crashpad::set_crashpad_upload_compression_threshold);
+	ClassDB::bind_method(D_METHOD("get_upload_compression_threshold"), &Crashpad::get_crashpad_upload_compression_threshold);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "crashpad_settings/upload_compression_threshold_bytes", PROPERTY_HINT_RANGE, "0,104857600,1", PROPERTY_USAGE_DEFAULT_INTL), "set_upload_compression_threshold", "get_upload_compression_threshold");
+    ClassDB::bind_method(D_METHOD("set_dump_profile", "profile"), &Crashpad::set_crashpad_dump_profile);
+	ClassDB::bind_method(D_METHOD("get_dump_profile"), &Crashpad::get_crashpad_dump_profile);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "crashpad_settings/dump_profile", PROPERTY_HINT_ENUM, "Minimal,Standard,Full", PROPERTY_USAGE_DEFAULT_INTL), "set_dump_profile", "get_dump_profile");
+    ClassDB::bind_method(D_METHOD("set_linux_dump_wait_timeout", "timeout_msec"), &Crashpad::set_crashpad_linux_dump_wait_timeout);
+	ClassDB::bind_method(D_METHOD("get_linux_dump_wait_timeout"), &Crashpad::get_crashpad_linux_dump_wait_timeout);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "crashpad_settings/linux_dump_wait_timeout_msec", PROPERTY_HINT_RANGE, "0,60000,1", PROPERTY_USAGE_DEFAULT_INTL), "set_linux_dump_wait_timeout", "get_linux_dump_wait_timeout");
+
+    ClassDB::bind_method(D_METHOD("set_linux_deferred_upload", "deferred_upload"), &Crashpad::set_crashpad_linux_deferred_upload);
+	ClassDB::bind_method(D_METHOD("get_linux_deferred_upload"), &Crashpad::get_crashpad_linux_deferred_upload);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "crashpad_settings/linux_deferred_upload", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_linux_deferred_upload", "get_linux_deferred_upload");
+    ClassDB::bind_method(D_METHOD("set_deferred_upload_max_attempts", "max_attempts"), &Crashpad::set_crashpad_deferred_upload_max_attempts);
+	ClassDB::bind_method(D_METHOD("get_deferred_upload_max_attempts"), &Crashpad::get_crashpad_deferred_upload_max_attempts);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "crashpad_settings/deferred_upload_max_attempts", PROPERTY_HINT_RANGE, "1,100,1", PROPERTY_USAGE_DEFAULT_INTL), "set_deferred_upload_max_attempts", "get_deferred_upload_max_attempts");
+    ClassDB::bind_method(D_METHOD("set_deferred_upload_max_requests_per_minute", "max_requests"), &Crashpad::set_crashpad_deferred_upload_max_requests_per_minute);
+	ClassDB::bind_method(D_METHOD("get_deferred_upload_max_requests_per_minute"), &Crashpad::get_crashpad_deferred_upload_max_requests_per_minute);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "crashpad_settings/deferred_upload_max_requests_per_minute", PROPERTY_HINT_RANGE, "0,600,1", PROPERTY_USAGE_DEFAULT_INTL), "set_deferred_upload_max_requests_per_minute", "get_deferred_upload_max_requests_per_minute");
+    ClassDB::bind_method(D_METHOD("set_deferred_upload_max_bytes_per_second", "max_bytes"), &Crashpad::set_crashpad_deferred_upload_max_bytes_per_second);
+	ClassDB::bind_method(D_METHOD("get_deferred_upload_max_bytes_per_second"), &Crashpad::get_crashpad_deferred_upload_max_bytes_per_second);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "crashpad_settings/deferred_upload_max_bytes_per_second", PROPERTY_HINT_RANGE, "0,104857600,1", PROPERTY_USAGE_DEFAULT_INTL), "set_deferred_upload_max_bytes_per_second", "get_deferred_upload_max_bytes_per_second");
+
+    ClassDB::bind_method(D_METHOD("set_dedupe_window_hours", "window_hours"), &Crashpad::set_crashpad_dedupe_window_hours);
+	ClassDB::bind_method(D_METHOD("get_dedupe_window_hours"), &Crashpad::get_crashpad_dedupe_window_hours);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "crashpad_settings/dedupe_window_hours", PROPERTY_HINT_RANGE, "0,8760,1", PROPERTY_USAGE_DEFAULT_INTL), "set_dedupe_window_hours", "get_dedupe_window_hours");
+    ClassDB::bind_method(D_METHOD("set_dedupe_stack_frames", "stack_frames"), &Crashpad::set_crashpad_dedupe_stack_frames);
+	ClassDB::bind_method(D_METHOD("get_dedupe_stack_frames"), &Crashpad::get_crashpad_dedupe_stack_frames);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "crashpad_settings/dedupe_stack_frames", PROPERTY_HINT_RANGE, "1,64,1", PROPERTY_USAGE_DEFAULT_INTL), "set_dedupe_stack_frames", "get_dedupe_stack_frames");
+
+    ClassDB::bind_method(D_METHOD("set_upload_sampling_percent", "sampling_percent"), &Crashpad::set_crashpad_upload_sampling_percent);
+	ClassDB::bind_method(D_METHOD("get_upload_sampling_percent"), &Crashpad::get_crashpad_upload_sampling_percent);
+    // Per report on Linux, per session on Windows and MacOS (where the handler uploads by itself)
+    ADD_PROPERTY(PropertyInfo(Variant::REAL, "crashpad_settings/upload_sampling_percent", PROPERTY_HINT_RANGE, "0,100,0.01", PROPERTY_USAGE_DEFAULT_INTL), "set_upload_sampling_percent", "get_upload_sampling_percent");
+    ClassDB::bind_method(D_METHOD("set_max_uploads_per_hour", "max_uploads"), &Crashpad::set_crashpad_max_uploads_per_hour);
+	ClassDB::bind_method(D_METHOD("get_max_uploads_per_hour"), &Crashpad::get_crashpad_max_uploads_per_hour);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "crashpad_settings/max_uploads_per_hour", PROPERTY_HINT_RANGE, "0,1000,1", PROPERTY_USAGE_DEFAULT_INTL), "set_max_uploads_per_hour", "get_max_uploads_per_hour");
+    ClassDB::bind_method(D_METHOD("set_max_uploads_per_signature_per_day", "max_uploads"), &Crashpad::set_crashpad_max_uploads_per_signature_per_day);
+	ClassDB::bind_method(D_METHOD("get_max_uploads_per_signature_per_day"), &Crashpad::get_crashpad_max_uploads_per_signature_per_day);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "crashpad_settings/max_uploads_per_signature_per_day", PROPERTY_HINT_RANGE, "0,1000,1", PROPERTY_USAGE_DEFAULT_INTL), "set_max_uploads_per_signature_per_day", "get_max_uploads_per_signature_per_day");
     // =====
 
     // User custom data
@@ -449,11 +1484,93 @@ void Crashpad::_bind_methods() {
     ClassDB::bind_method(D_METHOD("set_upload_godot_log", "upload_godot_log"), &Crashpad::set_crashpad_upload_godot_log);
 	ClassDB::bind_method(D_METHOD("get_upload_godot_log"), &Crashpad::get_crashpad_upload_godot_log);
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "custom_data/upload_godot_log", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_upload_godot_log", "get_upload_godot_log");
+    ClassDB::bind_method(D_METHOD("set_log_attachment_mode", "mode"), &Crashpad::set_crashpad_log_attachment_mode);
+	ClassDB::bind_method(D_METHOD("get_log_attachment_mode"), &Crashpad::get_crashpad_log_attachment_mode);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "custom_data/log_attachment_mode", PROPERTY_HINT_ENUM, "Full File,File Tail,Memory Buffer", PROPERTY_USAGE_DEFAULT_INTL), "set_log_attachment_mode", "get_log_attachment_mode");
+    ClassDB::bind_method(D_METHOD("set_log_tail_size_kb", "size_kb"), &Crashpad::set_crashpad_log_tail_size_kb);
+	ClassDB::bind_method(D_METHOD("get_log_tail_size_kb"), &Crashpad::get_crashpad_log_tail_size_kb);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "custom_data/log_tail_size_kb", PROPERTY_HINT_RANGE, "1,4096,1", PROPERTY_USAGE_DEFAULT_INTL), "set_log_tail_size_kb", "get_log_tail_size_kb");
+    ClassDB::bind_method(D_METHOD("set_log_tail_lines", "lines"), &Crashpad::set_crashpad_log_tail_lines);
+	ClassDB::bind_method(D_METHOD("get_log_tail_lines"), &Crashpad::get_crashpad_log_tail_lines);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "custom_data/log_tail_lines", PROPERTY_HINT_RANGE, "0,100000,1", PROPERTY_USAGE_DEFAULT_INTL), "set_log_tail_lines", "get_log_tail_lines");
+
+    BIND_ENUM_CONSTANT(LOG_ATTACHMENT_FULL_FILE);
+    BIND_ENUM_CONSTANT(LOG_ATTACHMENT_FILE_TAIL);
+    BIND_ENUM_CONSTANT(LOG_ATTACHMENT_MEMORY_BUFFER);
     // =====
 
     ClassDB::bind_method(D_METHOD("set_skip_error_upload", "skip_error_upload"), &Crashpad::set_crashpad_skip_error_upload);
 	ClassDB::bind_method(D_METHOD("get_skip_error_upload"), &Crashpad::get_crashpad_skip_error_upload);
     ADD_PROPERTY(PropertyInfo(Variant::BOOL, "skip_error_upload", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_skip_error_upload", "get_skip_error_upload");
+
+    // Session tracking
+    // =====
+    ClassDB::bind_method(D_METHOD("set_session_tracking", "enabled"), &Crashpad::set_crashpad_session_tracking);
+	ClassDB::bind_method(D_METHOD("get_session_tracking"), &Crashpad::get_crashpad_session_tracking);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "session_tracking/enabled", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_session_tracking", "get_session_tracking");
+    ClassDB::bind_method(D_METHOD("set_session_events_url", "events_url"), &Crashpad::set_crashpad_session_events_url);
+	ClassDB::bind_method(D_METHOD("get_session_events_url"), &Crashpad::get_crashpad_session_events_url);
+    ADD_PROPERTY(PropertyInfo(Variant::STRING, "session_tracking/events_url", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_session_events_url", "get_session_events_url");
+    ClassDB::bind_method(D_METHOD("set_session_batch_size", "batch_size"), &Crashpad::set_crashpad_session_batch_size);
+	ClassDB::bind_method(D_METHOD("get_session_batch_size"), &Crashpad::get_crashpad_session_batch_size);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "session_tracking/batch_size", PROPERTY_HINT_RANGE, "1,500,1", PROPERTY_USAGE_DEFAULT_INTL), "set_session_batch_size", "get_session_batch_size");
+    // =====
+
+    // Error reporting
+    // =====
+    ClassDB::bind_method(D_METHOD("set_error_reporting", "enabled"), &Crashpad::set_crashpad_error_reporting);
+	ClassDB::bind_method(D_METHOD("get_error_reporting"), &Crashpad::get_crashpad_error_reporting);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "error_reporting/enabled", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_error_reporting", "get_error_reporting");
+    ClassDB::bind_method(D_METHOD("set_capture_engine_errors", "capture_engine_errors"), &Crashpad::set_crashpad_capture_engine_errors);
+	ClassDB::bind_method(D_METHOD("get_capture_engine_errors"), &Crashpad::get_crashpad_capture_engine_errors);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "error_reporting/capture_engine_errors", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_capture_engine_errors", "get_capture_engine_errors");
+    ClassDB::bind_method(D_METHOD("set_error_flush_interval", "interval_sec"), &Crashpad::set_crashpad_error_flush_interval);
+	ClassDB::bind_method(D_METHOD("get_error_flush_interval"), &Crashpad::get_crashpad_error_flush_interval);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "error_reporting/flush_interval_sec", PROPERTY_HINT_RANGE, "1,3600,1", PROPERTY_USAGE_DEFAULT_INTL), "set_error_flush_interval", "get_error_flush_interval");
+    ClassDB::bind_method(D_METHOD("set_error_max_batch_size", "max_batch_size"), &Crashpad::set_crashpad_error_max_batch_size);
+	ClassDB::bind_method(D_METHOD("get_error_max_batch_size"), &Crashpad::get_crashpad_error_max_batch_size);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "error_reporting/max_batch_size", PROPERTY_HINT_RANGE, "1,1000,1", PROPERTY_USAGE_DEFAULT_INTL), "set_error_max_batch_size", "get_error_max_batch_size");
+    // =====
+
+    // Hang detection
+    // =====
+    ClassDB::bind_method(D_METHOD("set_watchdog_enabled", "enabled"), &Crashpad::set_crashpad_watchdog_enabled);
+	ClassDB::bind_method(D_METHOD("get_watchdog_enabled"), &Crashpad::get_crashpad_watchdog_enabled);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "watchdog/enabled", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_watchdog_enabled", "get_watchdog_enabled");
+    ClassDB::bind_method(D_METHOD("set_watchdog_hang_threshold", "threshold_msec"), &Crashpad::set_crashpad_watchdog_hang_threshold);
+	ClassDB::bind_method(D_METHOD("get_watchdog_hang_threshold"), &Crashpad::get_crashpad_watchdog_hang_threshold);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "watchdog/hang_threshold_msec", PROPERTY_HINT_RANGE, "100,600000,1", PROPERTY_USAGE_DEFAULT_INTL), "set_watchdog_hang_threshold", "get_watchdog_hang_threshold");
+    // =====
+
+    // Engine telemetry
+    // =====
+    ClassDB::bind_method(D_METHOD("set_telemetry_enabled", "enabled"), &Crashpad::set_crashpad_telemetry_enabled);
+	ClassDB::bind_method(D_METHOD("get_telemetry_enabled"), &Crashpad::get_crashpad_telemetry_enabled);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "telemetry/enabled", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_telemetry_enabled", "get_telemetry_enabled");
+    ClassDB::bind_method(D_METHOD("set_telemetry_metrics", "metrics"), &Crashpad::set_crashpad_telemetry_metrics);
+	ClassDB::bind_method(D_METHOD("get_telemetry_metrics"), &Crashpad::get_crashpad_telemetry_metrics);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "telemetry/metrics", PROPERTY_HINT_FLAGS, "Frame Time,Physics Time,Static Memory,Dynamic Memory,Objects,Nodes,Draw Calls,Video Memory", PROPERTY_USAGE_DEFAULT_INTL), "set_telemetry_metrics", "get_telemetry_metrics");
+    ClassDB::bind_method(D_METHOD("set_telemetry_sample_interval", "interval_msec"), &Crashpad::set_crashpad_telemetry_sample_interval);
+	ClassDB::bind_method(D_METHOD("get_telemetry_sample_interval"), &Crashpad::get_crashpad_telemetry_sample_interval);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "telemetry/sample_interval_msec", PROPERTY_HINT_RANGE, "0,60000,1", PROPERTY_USAGE_DEFAULT_INTL), "set_telemetry_sample_interval", "get_telemetry_sample_interval");
+    ClassDB::bind_method(D_METHOD("set_telemetry_window_size", "samples"), &Crashpad::set_crashpad_telemetry_window_size);
+	ClassDB::bind_method(D_METHOD("get_telemetry_window_size"), &Crashpad::get_crashpad_telemetry_window_size);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "telemetry/window_size", PROPERTY_HINT_RANGE, "1,4096,1", PROPERTY_USAGE_DEFAULT_INTL), "set_telemetry_window_size", "get_telemetry_window_size");
+
+    // Crash screenshot
+    ClassDB::bind_method(D_METHOD("set_screenshot_enabled", "enabled"), &Crashpad::set_crashpad_screenshot_enabled);
+	ClassDB::bind_method(D_METHOD("get_screenshot_enabled"), &Crashpad::get_crashpad_screenshot_enabled);
+    ADD_PROPERTY(PropertyInfo(Variant::BOOL, "screenshot/enabled", PROPERTY_HINT_NONE, "", PROPERTY_USAGE_DEFAULT_INTL), "set_screenshot_enabled", "get_screenshot_enabled");
+    ClassDB::bind_method(D_METHOD("set_screenshot_interval", "interval_msec"), &Crashpad::set_crashpad_screenshot_interval);
+	ClassDB::bind_method(D_METHOD("get_screenshot_interval"), &Crashpad::get_crashpad_screenshot_interval);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "screenshot/interval_msec", PROPERTY_HINT_RANGE, "1000,600000,1", PROPERTY_USAGE_DEFAULT_INTL), "set_screenshot_interval", "get_screenshot_interval");
+    ClassDB::bind_method(D_METHOD("set_screenshot_max_dimension", "pixels"), &Crashpad::set_crashpad_screenshot_max_dimension);
+	ClassDB::bind_method(D_METHOD("get_screenshot_max_dimension"), &Crashpad::get_crashpad_screenshot_max_dimension);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "screenshot/max_dimension", PROPERTY_HINT_RANGE, "32,4096,1", PROPERTY_USAGE_DEFAULT_INTL), "set_screenshot_max_dimension", "get_screenshot_max_dimension");
+    ClassDB::bind_method(D_METHOD("set_screenshot_max_size_kb", "size_kb"), &Crashpad::set_crashpad_screenshot_max_size_kb);
+	ClassDB::bind_method(D_METHOD("get_screenshot_max_size_kb"), &Crashpad::get_crashpad_screenshot_max_size_kb);
+    ADD_PROPERTY(PropertyInfo(Variant::INT, "screenshot/max_size_kb", PROPERTY_HINT_RANGE, "8,4096,1", PROPERTY_USAGE_DEFAULT_INTL), "set_screenshot_max_size_kb", "get_screenshot_max_size_kb");
+    // =====
 }
 
 void Crashpad::set_crashpad_api_url(String new_url)
@@ -488,6 +1605,30 @@ String Crashpad::get_crashpad_database_path()
 {
     return Crashpad::crashpad_database_path;
 }
+void Crashpad::set_crashpad_async_start(bool new_value)
+{
+    Crashpad::crashpad_async_start = new_value;
+}
+bool Crashpad::get_crashpad_async_start()
+{
+    return Crashpad::crashpad_async_start;
+}
+void Crashpad::set_crashpad_shared_handler(bool new_value)
+{
+    Crashpad::crashpad_shared_handler = new_value;
+}
+bool Crashpad::get_crashpad_shared_handler()
+{
+    return Crashpad::crashpad_shared_handler;
+}
+void Crashpad::set_crashpad_shared_handler_name(String new_value)
+{
+    Crashpad::crashpad_shared_handler_name = new_value;
+}
+String Crashpad::get_crashpad_shared_handler_name()
+{
+    return Crashpad::crashpad_shared_handler_name;
+}
 
 void Crashpad::set_crashpad_skip_error_upload(bool new_value)
 {
@@ -501,6 +1642,17 @@ bool Crashpad::get_crashpad_skip_error_upload()
 void Crashpad::set_crashpad_user_crash_attributes(Dictionary new_value)
 {
     Crashpad::crashpad_user_crash_attributes = new_value;
+
+    // The handler only got the attributes it was started with, so changes go through the live annotations
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+    if (crashpad_client_init == true)
+    {
+        for (int i = 0; i < new_value.size(); i++)
+        {
+            CrashpadAnnotations::set((String)new_value.get_key_at_index(i), (String)new_value.get_value_at_index(i));
+        }
+    }
+#endif
 }
 Dictionary Crashpad::get_crashpad_user_crash_attributes()
 {
@@ -513,6 +1665,24 @@ void Crashpad::set_crashpad_upload_godot_log(bool new_value) {
 bool Crashpad::get_crashpad_upload_godot_log() {
     return Crashpad::crashpad_upload_godot_log;
 }
+void Crashpad::set_crashpad_log_attachment_mode(int new_value) {
+    Crashpad::crashpad_log_attachment_mode = new_value;
+}
+int Crashpad::get_crashpad_log_attachment_mode() {
+    return Crashpad::crashpad_log_attachment_mode;
+}
+void Crashpad::set_crashpad_log_tail_size_kb(int new_value) {
+    Crashpad::crashpad_log_tail_size_kb = new_value;
+}
+int Crashpad::get_crashpad_log_tail_size_kb() {
+    return Crashpad::crashpad_log_tail_size_kb;
+}
+void Crashpad::set_crashpad_log_tail_lines(int new_value) {
+    Crashpad::crashpad_log_tail_lines = new_value;
+}
+int Crashpad::get_crashpad_log_tail_lines() {
+    return Crashpad::crashpad_log_tail_lines;
+}
 
 void Crashpad::set_crashpad_use_manual_application_extension(bool new_value) {
     Crashpad::crashpad_use_manual_application_extension = true;
@@ -527,6 +1697,288 @@ String Crashpad::get_crashpad_manual_application_extension() {
     return Crashpad::crashpad_manual_application_extension;
 }
 
+void Crashpad::set_crashpad_upload_connect_timeout(int new_value) {
+    Crashpad::crashpad_upload_connect_timeout = new_value;
+}
+int Crashpad::get_crashpad_upload_connect_timeout() {
+    return Crashpad::crashpad_upload_connect_timeout;
+}
+void Crashpad::set_crashpad_upload_total_timeout(int new_value) {
+    Crashpad::crashpad_upload_total_timeout = new_value;
+}
+int Crashpad::get_crashpad_upload_total_timeout() {
+    return Crashpad::crashpad_upload_total_timeout;
+}
+void Crashpad::set_crashpad_upload_compression(int new_value) {
+    Crashpad::crashpad_upload_compression = new_value;
+}
+int Crashpad::get_crashpad_upload_compression() {
+    return Crashpad::crashpad_upload_compression;
+}
+void Crashpad::set_crashpad_upload_compression_threshold(int new_value) {
+    Crashpad::crashpad_upload_compression_threshold = new_value;
+}
+int Crashpad::get_crashpad_upload_compression_threshold() {
+    return Crashpad::crashpad_upload_compression_threshold;
+}
+void Crashpad::set_crashpad_dump_profile(int new_value) {
+    Crashpad::crashpad_dump_profile = new_value;
+}
+int Crashpad::get_crashpad_dump_profile() {
+    return Crashpad::crashpad_dump_profile;
+}
+void Crashpad::set_crashpad_linux_dump_wait_timeout(int new_value) {
+    Crashpad::crashpad_linux_dump_wait_timeout = new_value;
+}
+int Crashpad::get_crashpad_linux_dump_wait_timeout() {
+    return Crashpad::crashpad_linux_dump_wait_timeout;
+}
+
+void Crashpad::set_crashpad_linux_deferred_upload(bool new_value) {
+    Crashpad::crashpad_linux_deferred_upload = new_value;
+}
+bool Crashpad::get_crashpad_linux_deferred_upload() {
+    return Crashpad::crashpad_linux_deferred_upload;
+}
+void Crashpad::set_crashpad_deferred_upload_max_attempts(int new_value) {
+    Crashpad::crashpad_deferred_upload_max_attempts = new_value;
+}
+int Crashpad::get_crashpad_deferred_upload_max_attempts() {
+    return Crashpad::crashpad_deferred_upload_max_attempts;
+}
+void Crashpad::set_crashpad_deferred_upload_max_requests_per_minute(int new_value) {
+    Crashpad::crashpad_deferred_upload_max_requests_per_minute = new_value;
+}
+int Crashpad::get_crashpad_deferred_upload_max_requests_per_minute() {
+    return Crashpad::crashpad_deferred_upload_max_requests_per_minute;
+}
+void Crashpad::set_crashpad_deferred_upload_max_bytes_per_second(int new_value) {
+    Crashpad::crashpad_deferred_upload_max_bytes_per_second = new_value;
+}
+int Crashpad::get_crashpad_deferred_upload_max_bytes_per_second() {
+    return Crashpad::crashpad_deferred_upload_max_bytes_per_second;
+}
+
+void Crashpad::set_crashpad_dedupe_window_hours(int new_value) {
+    Crashpad::crashpad_dedupe_window_hours = new_value;
+}
+int Crashpad::get_crashpad_dedupe_window_hours() {
+    return Crashpad::crashpad_dedupe_window_hours;
+}
+void Crashpad::set_crashpad_dedupe_stack_frames(int new_value) {
+    Crashpad::crashpad_dedupe_stack_frames = new_value;
+}
+int Crashpad::get_crashpad_dedupe_stack_frames() {
+    return Crashpad::crashpad_dedupe_stack_frames;
+}
+
+void Crashpad::set_crashpad_upload_sampling_percent(float new_value) {
+    Crashpad::crashpad_upload_sampling_percent = new_value;
+}
+float Crashpad::get_crashpad_upload_sampling_percent() {
+    return Crashpad::crashpad_upload_sampling_percent;
+}
+void Crashpad::set_crashpad_max_uploads_per_hour(int new_value) {
+    Crashpad::crashpad_max_uploads_per_hour = new_value;
+}
+int Crashpad::get_crashpad_max_uploads_per_hour() {
+    return Crashpad::crashpad_max_uploads_per_hour;
+}
+void Crashpad::set_crashpad_max_uploads_per_signature_per_day(int new_value) {
+    Crashpad::crashpad_max_uploads_per_signature_per_day = new_value;
+}
+int Crashpad::get_crashpad_max_uploads_per_signature_per_day() {
+    return Crashpad::crashpad_max_uploads_per_signature_per_day;
+}
+
+void Crashpad::set_crashpad_session_tracking(bool new_value) {
+    Crashpad::crashpad_session_tracking = new_value;
+}
+bool Crashpad::get_crashpad_session_tracking() {
+    return Crashpad::crashpad_session_tracking;
+}
+void Crashpad::set_crashpad_session_events_url(String new_value) {
+    Crashpad::crashpad_session_events_url = new_value;
+}
+String Crashpad::get_crashpad_session_events_url() {
+    return Crashpad::crashpad_session_events_url;
+}
+void Crashpad::set_crashpad_session_batch_size(int new_value) {
+    Crashpad::crashpad_session_batch_size = new_value;
+}
+int Crashpad::get_crashpad_session_batch_size() {
+    return Crashpad::crashpad_session_batch_size;
+}
+
+void Crashpad::set_crashpad_error_reporting(bool new_value) {
+    Crashpad::crashpad_error_reporting = new_value;
+}
+bool Crashpad::get_crashpad_error_reporting() {
+    return Crashpad::crashpad_error_reporting;
+}
+void Crashpad::set_crashpad_capture_engine_errors(bool new_value) {
+    Crashpad::crashpad_capture_engine_errors = new_value;
+}
+bool Crashpad::get_crashpad_capture_engine_errors() {
+    return Crashpad::crashpad_capture_engine_errors;
+}
+void Crashpad::set_crashpad_error_flush_interval(int new_value) {
+    Crashpad::crashpad_error_flush_interval = new_value;
+}
+int Crashpad::get_crashpad_error_flush_interval() {
+    return Crashpad::crashpad_error_flush_interval;
+}
+void Crashpad::set_crashpad_error_max_batch_size(int new_value) {
+    Crashpad::crashpad_error_max_batch_size = new_value;
+}
+int Crashpad::get_crashpad_error_max_batch_size() {
+    return Crashpad::crashpad_error_max_batch_size;
+}
+
+void Crashpad::set_crashpad_watchdog_enabled(bool new_value) {
+    Crashpad::crashpad_watchdog_enabled = new_value;
+}
+bool Crashpad::get_crashpad_watchdog_enabled() {
+    return Crashpad::crashpad_watchdog_enabled;
+}
+void Crashpad::set_crashpad_watchdog_hang_threshold(int new_value) {
+    Crashpad::crashpad_watchdog_hang_threshold = new_value;
+}
+int Crashpad::get_crashpad_watchdog_hang_threshold() {
+    return Crashpad::crashpad_watchdog_hang_threshold;
+}
+
+void Crashpad::set_crashpad_telemetry_enabled(bool new_value) {
+    Crashpad::crashpad_telemetry_enabled = new_value;
+}
+bool Crashpad::get_crashpad_telemetry_enabled() {
+    return Crashpad::crashpad_telemetry_enabled;
+}
+void Crashpad::set_crashpad_telemetry_metrics(int new_value) {
+    Crashpad::crashpad_telemetry_metrics = new_value;
+}
+int Crashpad::get_crashpad_telemetry_metrics() {
+    return Crashpad::crashpad_telemetry_metrics;
+}
+void Crashpad::set_crashpad_telemetry_sample_interval(int new_value) {
+    Crashpad::crashpad_telemetry_sample_interval = new_value;
+}
+int Crashpad::get_crashpad_telemetry_sample_interval() {
+    return Crashpad::crashpad_telemetry_sample_interval;
+}
+void Crashpad::set_crashpad_telemetry_window_size(int new_value) {
+    Crashpad::crashpad_telemetry_window_size = new_value;
+}
+int Crashpad::get_crashpad_telemetry_window_size() {
+    return Crashpad::crashpad_telemetry_window_size;
+}
+
+void Crashpad::set_crashpad_screenshot_enabled(bool new_value) {
+    Crashpad::crashpad_screenshot_enabled = new_value;
+}
+bool Crashpad::get_crashpad_screenshot_enabled() {
+    return Crashpad::crashpad_screenshot_enabled;
+}
+void Crashpad::set_crashpad_screenshot_interval(int new_value) {
+    Crashpad::crashpad_screenshot_interval = new_value;
+}
+int Crashpad::get_crashpad_screenshot_interval() {
+    return Crashpad::crashpad_screenshot_interval;
+}
+void Crashpad::set_crashpad_screenshot_max_dimension(int new_value) {
+    Crashpad::crashpad_screenshot_max_dimension = new_value;
+}
+int Crashpad::get_crashpad_screenshot_max_dimension() {
+    return Crashpad::crashpad_screenshot_max_dimension;
+}
+void Crashpad::set_crashpad_screenshot_max_size_kb(int new_value) {
+    Crashpad::crashpad_screenshot_max_size_kb = new_value;
+}
+int Crashpad::get_crashpad_screenshot_max_size_kb() {
+    return Crashpad::crashpad_screenshot_max_size_kb;
+}
+
+void Crashpad::add_breadcrumb(String category, String message)
+{
+    CrashpadBreadcrumbs::add(category, message);
+}
+
+void Crashpad::clear_breadcrumbs()
+{
+    CrashpadBreadcrumbs::clear();
+}
+
+void Crashpad::set_annotation(String key, String value)
+{
+    CrashpadAnnotations::set(key, value);
+}
+
+void Crashpad::remove_annotation(String key)
+{
+    CrashpadAnnotations::remove(key);
+}
+
+void Crashpad::clear_annotations()
+{
+    CrashpadAnnotations::clear();
+}
+
+void Crashpad::report_error(String message, Dictionary attributes)
+{
+    crashpad_error_reporter.report(message, attributes);
+}
+
+bool Crashpad::add_memory_block(String key, PoolByteArray data)
+{
+    return CrashpadMemoryRanges::set_block(key, data);
+}
+
+void Crashpad::remove_memory_block(String key)
+{
+    CrashpadMemoryRanges::remove_block(key);
+}
+
+void Crashpad::clear_memory_blocks()
+{
+    CrashpadMemoryRanges::clear_blocks();
+}
+
+Dictionary Crashpad::run_benchmark(Dictionary options)
+{
+    Dictionary results = CrashpadBenchmark::run(options);
+
+    // Startup cost of this node, as configured in the project (starts the handler for real)
+    if (options.has("measure_start") && (bool)options["measure_start"] == true)
+    {
+        uint64_t start = OS::get_singleton()->get_ticks_usec();
+        start_crashpad();
+        results["start_crashpad_msec"] = (OS::get_singleton()->get_ticks_usec() - start) / 1000.0;
+    }
+
+    // Headless builds cannot read frames back, so they must not take (or spend time on) screenshots
+    CrashpadScreenshot screenshot;
+    screenshot.start();
+    bool captured = is_inside_tree() == true && screenshot.capture(this);
+    screenshot.stop();
+    results["screenshot_captured"] = captured;
+    if (captured == true && OS::get_singleton()->get_name() == "Server")
+    {
+        results["screenshot_error"] = "A screenshot was taken by a headless build.";
+    }
+    return results;
+}
+
+bool Crashpad::capture_screenshot()
+{
+    // Takes the next screenshot now instead of waiting for the interval. False if there will be no image,
+    // which is what a headless build (dummy renderer) gives.
+    if (is_inside_tree() == false)
+    {
+        return false;
+    }
+    return crashpad_screenshot.capture(this);
+}
+
 void Crashpad::force_crash()
 {
     volatile int* a = (int*)(NULL); *a = 1;
@@ -538,17 +1990,85 @@ Crashpad::Crashpad()
     Crashpad::crashpad_api_URL = get("crashpad_settings/api_url");
     Crashpad::crashpad_api_token = get("crashpad_settings/api_token");
     Crashpad::crashpad_application_path = get("crashpad_settings/application_path");
+    Crashpad::crashpad_async_start = get("crashpad_settings/async_start");
+    Crashpad::crashpad_shared_handler = get("crashpad_settings/shared_handler");
+    Crashpad::crashpad_shared_handler_name = get("crashpad_settings/shared_handler_name");
 
     Crashpad::crashpad_user_crash_attributes = get("custom_data/user_crash_attributes");
     Crashpad::crashpad_upload_godot_log = get("custom_data/upload_godot_log");
+    Crashpad::crashpad_log_attachment_mode = get("custom_data/log_attachment_mode");
+    Crashpad::crashpad_log_tail_size_kb = get("custom_data/log_tail_size_kb");
+    Crashpad::crashpad_log_tail_lines = get("custom_data/log_tail_lines");
 
     Crashpad::crashpad_skip_error_upload = get("skip_error_upload");
 
     Crashpad::crashpad_use_manual_application_extension = get("crashpad_settings/use_manual_application_extension");
     Crashpad::crashpad_manual_application_extension = get("crashpad_settings/manual_application_extension");
+
+    Crashpad::crashpad_upload_connect_timeout = get("crashpad_settings/upload_connect_timeout_msec");
+    Crashpad::crashpad_upload_total_timeout = get("crashpad_settings/upload_total_timeout_msec");
+    Crashpad::crashpad_upload_compression = get("crashpad_settings/upload_compression");
+    Crashpad::crashpad_upload_compression_threshold = get("crashpad_settings/upload_compression_threshold_bytes");
+    Crashpad::crashpad_dump_profile = get("crashpad_settings/dump_profile");
+    Crashpad::crashpad_linux_dump_wait_timeout = get("crashpad_settings/linux_dump_wait_timeout_msec");
+
+    Crashpad::crashpad_linux_deferred_upload = get("crashpad_settings/linux_deferred_upload");
+    Crashpad::crashpad_deferred_upload_max_attempts = get("crashpad_settings/deferred_upload_max_attempts");
+    Crashpad::crashpad_deferred_upload_max_requests_per_minute = get("crashpad_settings/deferred_upload_max_requests_per_minute");
+    Crashpad::crashpad_deferred_upload_max_bytes_per_second = get("crashpad_settings/deferred_upload_max_bytes_per_second");
+
+    Crashpad::crashpad_dedupe_window_hours = get("crashpad_settings/dedupe_window_hours");
+    Crashpad::crashpad_dedupe_stack_frames = get("crashpad_settings/dedupe_stack_frames");
+    Crashpad::crashpad_upload_sampling_percent = get("crashpad_settings/upload_sampling_percent");
+    Crashpad::crashpad_max_uploads_per_hour = get("crashpad_settings/max_uploads_per_hour");
+    Crashpad::crashpad_max_uploads_per_signature_per_day = get("crashpad_settings/max_uploads_per_signature_per_day");
+
+    Crashpad::crashpad_session_tracking = get("session_tracking/enabled");
+    Crashpad::crashpad_session_events_url = get("session_tracking/events_url");
+    Crashpad::crashpad_session_batch_size = get("session_tracking/batch_size");
+
+    Crashpad::crashpad_error_reporting = get("error_reporting/enabled");
+    Crashpad::crashpad_capture_engine_errors = get("error_reporting/capture_engine_errors");
+    Crashpad::crashpad_error_flush_interval = get("error_reporting/flush_interval_sec");
+    Crashpad::crashpad_error_max_batch_size = get("error_reporting/max_batch_size");
+
+    Crashpad::crashpad_watchdog_enabled = get("watchdog/enabled");
+    Crashpad::crashpad_watchdog_hang_threshold = get("watchdog/hang_threshold_msec");
+
+    Crashpad::crashpad_telemetry_enabled = get("telemetry/enabled");
+    Crashpad::crashpad_telemetry_metrics = get("telemetry/metrics");
+    Crashpad::crashpad_telemetry_sample_interval = get("telemetry/sample_interval_msec");
+    Crashpad::crashpad_telemetry_window_size = get("telemetry/window_size");
+    Crashpad::crashpad_screenshot_enabled = get("screenshot/enabled");
+    Crashpad::crashpad_screenshot_interval = get("screenshot/interval_msec");
+    Crashpad::crashpad_screenshot_max_dimension = get("screenshot/max_dimension");
+    Crashpad::crashpad_screenshot_max_size_kb = get("screenshot/max_size_kb");
 }
 
 Crashpad::~Crashpad()
 {
-
+    if (crashpad_start_thread.is_started())
+    {
+        crashpad_start_thread.wait_to_finish();
+    }
+    if (crashpad_early_crash_thread.is_started())
+    {
+        crashpad_early_crash_uploader.cancel();
+        crashpad_early_crash_thread.wait_to_finish();
+    }
+    crashpad_hang_uploader.cancel();
+    crashpad_watchdog.stop();
+    crashpad_screenshot.stop();
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+    // The ring goes away with the node
+    CrashpadCrashHook::remove_callback(&_write_telemetry_annotation, &crashpad_telemetry);
+#endif
+    crashpad_upload_queue.stop();
+    crashpad_error_reporter.stop();
+    // Getting here means the game did not crash
+    crashpad_session_tracker.end();
+    if (crashpad_unsampled_marker_path.empty() == false)
+    {
+        DirAccess::remove_file_or_error(crashpad_unsampled_marker_path);
+    }
 }
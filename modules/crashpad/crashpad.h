@@ -6,8 +6,36 @@
 #include "scene/main/node.h"
 #include "core/reference.h"
 #include "core/os/dir_access.h"
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+#include "crashpad_annotations.h"
+#include "crashpad_benchmark.h"
+#include "crashpad_breadcrumbs.h"
+#include "crashpad_compression.h"
+#include "crashpad_crash_hook.h"
+#include "crashpad_dump_watcher.h"
+#include "crashpad_error_reporter.h"
+#include "crashpad_log_buffer.h"
+#include "crashpad_memory_ranges.h"
+#include "crashpad_platform.h"
+#include "crashpad_rate_limiter.h"
+#include "crashpad_screenshot.h"
+#include "crashpad_script_stack.h"
+#include "crashpad_signature.h"
+#include "crashpad_signature_cache.h"
+#include "crashpad_startup_cache.h"
+#include "crashpad_string_utils.h"
+#include "crashpad_telemetry.h"
+#include "crashpad_report_index.h"
+#include "crashpad_session_tracker.h"
+#include "crashpad_upload_queue.h"
+#include "crashpad_uploader.h"
+#include "crashpad_watchdog.h"
 
-#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined X11_ENABLED
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+#include "crashpad/client/annotation.h"
+#include "crashpad/client/annotation_list.h"
 #include "crashpad/client/crash_report_database.h"
 #include "crashpad/client/crashpad_client.h"
 #include "crashpad/client/settings.h"
@@ -21,9 +49,19 @@ protected:
     void _notification(int p_notification);
 
 public:
+    enum LogAttachmentMode {
+        LOG_ATTACHMENT_FULL_FILE,
+        LOG_ATTACHMENT_FILE_TAIL,
+        LOG_ATTACHMENT_MEMORY_BUFFER,
+    };
+
     static bool crashpad_skip_error_upload;
     static Dictionary crashpad_user_crash_attributes;
     static bool crashpad_upload_godot_log;
+    static int crashpad_log_attachment_mode;
+    static int crashpad_log_tail_size_kb;
+    static int crashpad_log_tail_lines;
+    static CrashpadLogBuffer *crashpad_log_buffer;
 
     static String crashpad_api_URL;
     static String crashpad_api_token;
@@ -32,23 +70,104 @@ public:
     static bool crashpad_linux_delete_crashpad_database_data_on_start;
     static bool crashpad_use_manual_application_extension;
     static String crashpad_manual_application_extension;
+    static int crashpad_upload_connect_timeout;
+    static int crashpad_upload_total_timeout;
+    static int crashpad_upload_compression;
+    static int crashpad_upload_compression_threshold;
+    static int crashpad_dump_profile;
+    static int crashpad_linux_dump_wait_timeout;
+    static bool crashpad_linux_deferred_upload;
+    static int crashpad_deferred_upload_max_attempts;
+    static int crashpad_deferred_upload_max_requests_per_minute;
+    static int crashpad_deferred_upload_max_bytes_per_second;
+    static int crashpad_dedupe_window_hours;
+    static int crashpad_dedupe_stack_frames;
+    // On Linux each report is sampled by itself. On Windows and MacOS the handler uploads by itself, so a whole
+    // session is sampled in or out (and the per signature caps do not apply there).
+    static float crashpad_upload_sampling_percent;
+    static bool crashpad_session_tracking;
+    static String crashpad_session_events_url;
+    static int crashpad_session_batch_size;
+    static bool crashpad_error_reporting;
+    static bool crashpad_capture_engine_errors;
+    static int crashpad_error_flush_interval;
+    static int crashpad_error_max_batch_size;
+    static int crashpad_max_uploads_per_hour;
+    static int crashpad_max_uploads_per_signature_per_day;
+    static bool crashpad_watchdog_enabled;
+    static int crashpad_watchdog_hang_threshold;
+    static bool crashpad_async_start;
+    static bool crashpad_shared_handler;
+    static String crashpad_shared_handler_name;
+    static bool crashpad_telemetry_enabled;
+    static int crashpad_telemetry_metrics;
+    static int crashpad_telemetry_sample_interval;
+    static int crashpad_telemetry_window_size;
+    static bool crashpad_screenshot_enabled;
+    static int crashpad_screenshot_interval;
+    static int crashpad_screenshot_max_dimension;
+    static int crashpad_screenshot_max_size_kb;
 
-    #if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined X11_ENABLED
+    #if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
     crashpad::CrashpadClient crashpad_client;
     bool crashpad_client_init = false;
     std::map<std::string, std::string> crashpad_annotations;
     std::vector<std::string> crashpad_arguments;
     #endif
 
+    CrashpadUploader crashpad_uploader;
+    CrashpadDumpWatcher crashpad_dump_watcher;
+    CrashpadReportIndex crashpad_report_index;
+    CrashpadUploadQueue crashpad_upload_queue;
+    CrashpadSignatureCache crashpad_signature_cache;
+    CrashpadRateLimiter crashpad_rate_limiter;
+    CrashpadSessionTracker crashpad_session_tracker;
+    CrashpadErrorReporter crashpad_error_reporter;
+    CrashpadWatchdog crashpad_watchdog;
+    CrashpadTelemetry crashpad_telemetry;
+    CrashpadScreenshot crashpad_screenshot;
+    CrashpadUploader crashpad_hang_uploader;
+    Mutex crashpad_dump_watcher_mutex;
+    Thread crashpad_start_thread;
+    SafeFlag crashpad_start_pending;
+    String crashpad_early_crash_marker_path;
+    // Set while this session is not sampled, see initialize_crashpad()
+    String crashpad_unsampled_marker_path;
+    Thread crashpad_early_crash_thread;
+    CrashpadUploader crashpad_early_crash_uploader;
+
     void start_crashpad();
     void force_crash();
 
+    void add_breadcrumb(String category, String message);
+    void clear_breadcrumbs();
+
+    void set_annotation(String key, String value);
+    void remove_annotation(String key);
+    void clear_annotations();
+
+    void report_error(String message, Dictionary attributes);
+
+    bool add_memory_block(String key, PoolByteArray data);
+    void remove_memory_block(String key);
+    void clear_memory_blocks();
+
+    // See CrashpadBenchmark::run() for the options
+    Dictionary run_benchmark(Dictionary options);
+    bool capture_screenshot();
+
     void set_crashpad_api_url(String new_url);
     String get_crashpad_api_url();
     void set_crashpad_api_token(String new_token);
     String get_crashpad_api_token();
     void set_crashpad_database_path(String new_path);
     String get_crashpad_database_path();
+    void set_crashpad_async_start(bool new_value);
+    bool get_crashpad_async_start();
+    void set_crashpad_shared_handler(bool new_value);
+    bool get_crashpad_shared_handler();
+    void set_crashpad_shared_handler_name(String new_value);
+    String get_crashpad_shared_handler_name();
     void set_crashpad_application_path(String new_path);
     String get_crashpad_application_path();
 
@@ -65,24 +184,120 @@ public:
 
     void set_crashpad_upload_godot_log(bool new_value);
     bool get_crashpad_upload_godot_log();
+    void set_crashpad_log_attachment_mode(int new_value);
+    int get_crashpad_log_attachment_mode();
+    void set_crashpad_log_tail_size_kb(int new_value);
+    int get_crashpad_log_tail_size_kb();
+    void set_crashpad_log_tail_lines(int new_value);
+    int get_crashpad_log_tail_lines();
+
+    void set_crashpad_upload_connect_timeout(int new_value);
+    int get_crashpad_upload_connect_timeout();
+    void set_crashpad_upload_total_timeout(int new_value);
+    int get_crashpad_upload_total_timeout();
+    void set_crashpad_upload_compression(int new_value);
+    int get_crashpad_upload_compression();
+    void set_crashpad_upload_compression_threshold(int new_value);
+    int get_crashpad_upload_compression_threshold();
+    void set_crashpad_dump_profile(int new_value);
+    int get_crashpad_dump_profile();
+    void set_crashpad_linux_dump_wait_timeout(int new_value);
+    int get_crashpad_linux_dump_wait_timeout();
+
+    void set_crashpad_linux_deferred_upload(bool new_value);
+    bool get_crashpad_linux_deferred_upload();
+    void set_crashpad_deferred_upload_max_attempts(int new_value);
+    int get_crashpad_deferred_upload_max_attempts();
+    void set_crashpad_deferred_upload_max_requests_per_minute(int new_value);
+    int get_crashpad_deferred_upload_max_requests_per_minute();
+    void set_crashpad_deferred_upload_max_bytes_per_second(int new_value);
+    int get_crashpad_deferred_upload_max_bytes_per_second();
+
+    void set_crashpad_dedupe_window_hours(int new_value);
+    int get_crashpad_dedupe_window_hours();
+    void set_crashpad_dedupe_stack_frames(int new_value);
+    int get_crashpad_dedupe_stack_frames();
+
+    void set_crashpad_upload_sampling_percent(float new_value);
+    float get_crashpad_upload_sampling_percent();
+    void set_crashpad_max_uploads_per_hour(int new_value);
+    int get_crashpad_max_uploads_per_hour();
+    void set_crashpad_max_uploads_per_signature_per_day(int new_value);
+    int get_crashpad_max_uploads_per_signature_per_day();
+
+    void set_crashpad_session_tracking(bool new_value);
+    bool get_crashpad_session_tracking();
+    void set_crashpad_session_events_url(String new_value);
+    String get_crashpad_session_events_url();
+    void set_crashpad_session_batch_size(int new_value);
+    int get_crashpad_session_batch_size();
+
+    void set_crashpad_error_reporting(bool new_value);
+    bool get_crashpad_error_reporting();
+    void set_crashpad_capture_engine_errors(bool new_value);
+    bool get_crashpad_capture_engine_errors();
+    void set_crashpad_error_flush_interval(int new_value);
+    int get_crashpad_error_flush_interval();
+    void set_crashpad_error_max_batch_size(int new_value);
+    int get_crashpad_error_max_batch_size();
+
+    void set_crashpad_watchdog_enabled(bool new_value);
+    bool get_crashpad_watchdog_enabled();
+    void set_crashpad_watchdog_hang_threshold(int new_value);
+    int get_crashpad_watchdog_hang_threshold();
+
+    void set_crashpad_telemetry_enabled(bool new_value);
+    bool get_crashpad_telemetry_enabled();
+    void set_crashpad_telemetry_metrics(int new_value);
+    int get_crashpad_telemetry_metrics();
+    void set_crashpad_telemetry_sample_interval(int new_value);
+    int get_crashpad_telemetry_sample_interval();
+    void set_crashpad_telemetry_window_size(int new_value);
+    int get_crashpad_telemetry_window_size();
+
+    void set_crashpad_screenshot_enabled(bool new_value);
+    bool get_crashpad_screenshot_enabled();
+    void set_crashpad_screenshot_interval(int new_value);
+    int get_crashpad_screenshot_interval();
+    void set_crashpad_screenshot_max_dimension(int new_value);
+    int get_crashpad_screenshot_max_dimension();
+    void set_crashpad_screenshot_max_size_kb(int new_value);
+    int get_crashpad_screenshot_max_size_kb();
 
     Crashpad();
     ~Crashpad();
 
 private:
+    bool initialize_crashpad();
+    static void _start_thread_func(void *p_userdata);
+    void write_early_crash_marker();
+    void report_early_crash();
+    static void _early_crash_thread_func(void *p_userdata);
+    bool connect_to_shared_handler(const String &handler_path, const String &database_path, const String &upload_url);
+    Error wait_for_own_dumps(int timeout_msec, Vector<String> &r_dumps);
+
+    void set_default_paths();
     bool check_for_crashpad_application();
     String get_global_crashpad_application_path();
     bool check_for_crashpad_database(bool make_if_not_exist);
     String get_global_path_from_local_path(String input_local_path);
 
-    #if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined X11_ENABLED
-    std::string get_std_string_from_godot_string(String input);
-    #endif
-
-    Array get_directory_contents(String root_directory_path, String desired_extension);
-    void _add_directory_contents(DirAccess *dir, Array files, Array directories, String desired_extension);
-    void upload_dump_through_curl(String dump_path);
+    void open_report_index();
+    void start_log_buffer();
+    void upload_new_dumps(CrashpadUploader &uploader, const Vector<String> &dumps, const Dictionary &attributes, bool upload_all_pending);
+    Error upload_dump(CrashpadUploader &uploader, String dump_path, const Dictionary &attributes, bool include_session_data);
+    Error upload_duplicate_record(CrashpadUploader &uploader, String dump_path, const CrashpadSignature &signature, uint32_t duplicate_count, const Dictionary &attributes);
+    Error post_report(CrashpadUploader &uploader, const String &url, CrashpadUploadBody *body, const Vector<String> &headers);
+    bool check_signature(const CrashpadSignature &signature, uint32_t &r_duplicate_count);
+    void record_signature(const CrashpadSignature &signature);
+    bool check_rate_limit(const String &dump_path, const String &signature_hash);
+    void record_upload(const String &signature_hash);
+    void report_hang(uint64_t hang_msec);
+    static void _on_hang(void *p_userdata, uint64_t p_hang_msec);
+    static Error _upload_dump_from_queue(void *p_userdata, CrashpadUploader &p_uploader, const String &p_dump_path, const Dictionary &p_attributes);
 
 };
 
+VARIANT_ENUM_CAST(Crashpad::LogAttachmentMode);
+
 #endif // CRASHPAD_H
\ No newline at end of file
@@ -0,0 +1,90 @@
+/* crashpad_annotations.cpp */
+
+#include "crashpad_annotations.h"
+#include "crashpad_string_utils.h"
+#include "crashpad_platform.h"
+
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+#include "crashpad/client/crashpad_info.h"
+#include "crashpad/client/simple_string_dictionary.h"
+
+static crashpad::SimpleStringDictionary crashpad_live_annotations;
+#endif
+
+Mutex CrashpadAnnotations::mutex;
+bool CrashpadAnnotations::registered = false;
+
+
+void CrashpadAnnotations::_register()
+{
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+    if (registered == false)
+    {
+        crashpad::CrashpadInfo::GetCrashpadInfo()->set_simple_annotations(&crashpad_live_annotations);
+        registered = true;
+    }
+#endif
+}
+
+void CrashpadAnnotations::set(const String &p_key, const String &p_value)
+{
+    char key[MAX_KEY_SIZE];
+    char value[MAX_VALUE_SIZE];
+    CrashpadStringUtils::copy_utf8(key, MAX_KEY_SIZE, p_key);
+    CrashpadStringUtils::copy_utf8(value, MAX_VALUE_SIZE, p_value);
+    set(key, value);
+}
+
+void CrashpadAnnotations::set(const char *p_key, const char *p_value)
+{
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+    mutex.lock();
+    _register();
+    crashpad_live_annotations.SetKeyValue(p_key, p_value);
+    mutex.unlock();
+#endif
+}
+
+void CrashpadAnnotations::remove(const String &p_key)
+{
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+    char key[MAX_KEY_SIZE];
+    CrashpadStringUtils::copy_utf8(key, MAX_KEY_SIZE, p_key);
+
+    mutex.lock();
+    crashpad_live_annotations.RemoveKey(key);
+    mutex.unlock();
+#endif
+}
+
+void CrashpadAnnotations::clear()
+{
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+    mutex.lock();
+    crashpad::SimpleStringDictionary::Iterator iterator(crashpad_live_annotations);
+    const crashpad::SimpleStringDictionary::Entry *entry = iterator.Next();
+    while (entry != nullptr)
+    {
+        crashpad_live_annotations.RemoveKey(entry->key);
+        entry = iterator.Next();
+    }
+    mutex.unlock();
+#endif
+}
+
+Dictionary CrashpadAnnotations::get_all()
+{
+    Dictionary annotations;
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+    mutex.lock();
+    crashpad::SimpleStringDictionary::Iterator iterator(crashpad_live_annotations);
+    const crashpad::SimpleStringDictionary::Entry *entry = iterator.Next();
+    while (entry != nullptr)
+    {
+        annotations[String::utf8(entry->key)] = String::utf8(entry->value);
+        entry = iterator.Next();
+    }
+    mutex.unlock();
+#endif
+    return annotations;
+}
@@ -0,0 +1,37 @@
+/* crashpad_annotations.h */
+
+#ifndef CRASHPAD_ANNOTATIONS_H
+#define CRASHPAD_ANNOTATIONS_H
+
+#include "core/dictionary.h"
+#include "core/os/mutex.h"
+#include "core/ustring.h"
+
+// Key/value annotations that can be changed while the game runs.
+// They live in a fixed size Crashpad SimpleStringDictionary registered with CrashpadInfo,
+// which the handler reads out of the process when it takes a dump. Updating one is a
+// UTF-8 conversion into stack buffers and a copy, with no heap allocation and no handler restart.
+class CrashpadAnnotations {
+public:
+    enum {
+        MAX_ENTRIES = 64,
+        MAX_KEY_SIZE = 256,
+        MAX_VALUE_SIZE = 256,
+    };
+
+private:
+    static Mutex mutex;
+    static bool registered;
+
+    static void _register();
+
+public:
+    static void set(const String &p_key, const String &p_value);
+    static void set(const char *p_key, const char *p_value);
+    static void remove(const String &p_key);
+    static void clear();
+    // Returns a copy of the annotations, for the Linux upload path which sends them itself.
+    static Dictionary get_all();
+};
+
+#endif // CRASHPAD_ANNOTATIONS_H
@@ -0,0 +1,678 @@
+/* crashpad_benchmark.cpp */
+
+#include "crashpad_benchmark.h"
+#include "core/crypto/crypto.h"
+#include "core/io/stream_peer_ssl.h"
+#include "core/io/tcp_server.h"
+#include "core/math/math_funcs.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+#include "core/os/thread.h"
+#include "core/project_settings.h"
+#include "core/safe_refcount.h"
+#include "crashpad_report_index.h"
+#include "crashpad_uploader.h"
+
+const char *CrashpadBenchmark::CRASH_ARGUMENT = "--crashpad-benchmark-crash";
+const char *CrashpadBenchmark::URL_ARGUMENT = "--crashpad-benchmark-url=";
+const char *CrashpadBenchmark::CRASH_TIME_ANNOTATION = "benchmark_crash_time_msec";
+
+// Only the start of each request body is searched for the crash time, the fields come before the dump
+#define CRASHPAD_BENCHMARK_SCAN_SIZE 65536
+#define CRASHPAD_BENCHMARK_REQUEST_TIMEOUT_MSEC 10000
+// Connect timeout of the uploader against a server that never finishes the TLS handshake
+#define CRASHPAD_BENCHMARK_STALL_TIMEOUT_MSEC 1000
+
+
+// A minimal HTTP/1.1 server that accepts any POST and answers "200 OK", over TLS if given a key.
+// It serves one connection at a time, which is all the uploader and a crashing child need.
+class CrashpadBenchmarkSink {
+    Ref<TCP_Server> server;
+    Ref<CryptoKey> key;
+    Ref<X509Certificate> certificate;
+    Thread thread;
+    SafeFlag exit_requested;
+    Mutex mutex;
+
+    int request_count = 0;
+    uint64_t received_bytes = 0;
+    int64_t crash_time_msec = -1;
+    int64_t crash_received_time_msec = -1;
+    uint64_t crash_received_ticks_msec = 0;
+
+    Ref<StreamPeerTCP> tcp;
+    Ref<StreamPeerSSL> ssl;
+    Ref<StreamPeer> connection;
+    uint8_t buffer[4096];
+    int buffer_position = 0;
+    int buffer_size = 0;
+
+    bool _accept();
+    bool _is_connected();
+    bool _fill_buffer(uint64_t p_deadline);
+    bool _read_line(String &r_line, uint64_t p_deadline);
+    bool _serve_request();
+    void _run();
+    static void _thread_func(void *p_userdata);
+
+public:
+    Error start(int p_port, const Ref<CryptoKey> &p_key = Ref<CryptoKey>(), const Ref<X509Certificate> &p_certificate = Ref<X509Certificate>());
+    void stop();
+
+    void get_counters(int &r_request_count, uint64_t &r_received_bytes);
+    // Returns false until a request with the crash time annotation arrived
+    bool get_crash(int64_t &r_crash_time_msec, int64_t &r_received_time_msec, uint64_t &r_received_ticks_msec);
+};
+
+Error CrashpadBenchmarkSink::start(int p_port, const Ref<CryptoKey> &p_key, const Ref<X509Certificate> &p_certificate)
+{
+    key = p_key;
+    certificate = p_certificate;
+    server.instance();
+    Error error = server->listen(p_port, IP_Address("127.0.0.1"));
+    if (error != OK)
+    {
+        return error;
+    }
+    exit_requested.clear();
+    thread.start(_thread_func, this);
+    return OK;
+}
+
+void CrashpadBenchmarkSink::stop()
+{
+    if (thread.is_started())
+    {
+        exit_requested.set();
+        thread.wait_to_finish();
+    }
+    if (server.is_valid())
+    {
+        server->stop();
+    }
+}
+
+void CrashpadBenchmarkSink::get_counters(int &r_request_count, uint64_t &r_received_bytes)
+{
+    mutex.lock();
+    r_request_count = request_count;
+    r_received_bytes = received_bytes;
+    mutex.unlock();
+}
+
+bool CrashpadBenchmarkSink::get_crash(int64_t &r_crash_time_msec, int64_t &r_received_time_msec, uint64_t &r_received_ticks_msec)
+{
+    mutex.lock();
+    bool received = crash_received_time_msec >= 0;
+    r_crash_time_msec = crash_time_msec;
+    r_received_time_msec = crash_received_time_msec;
+    r_received_ticks_msec = crash_received_ticks_msec;
+    mutex.unlock();
+    return received;
+}
+
+void CrashpadBenchmarkSink::_thread_func(void *p_userdata)
+{
+    ((CrashpadBenchmarkSink *)p_userdata)->_run();
+}
+
+void CrashpadBenchmarkSink::_run()
+{
+    while (exit_requested.is_set() == false)
+    {
+        if (server->is_connection_available() == false)
+        {
+            OS::get_singleton()->delay_usec(1000);
+            continue;
+        }
+
+        if (_accept() == true)
+        {
+            buffer_position = 0;
+            buffer_size = 0;
+            // Keep-alive: serve requests until the client hangs up
+            while (exit_requested.is_set() == false && _serve_request() == true)
+            {
+            }
+        }
+        if (ssl.is_valid())
+        {
+            ssl->disconnect_from_stream();
+        }
+        tcp->disconnect_from_host();
+        ssl.unref();
+        tcp.unref();
+        connection.unref();
+    }
+}
+
+bool CrashpadBenchmarkSink::_accept()
+{
+    tcp = server->take_connection();
+    tcp->set_no_delay(true);
+    if (key.is_null())
+    {
+        connection = tcp;
+        return true;
+    }
+
+    ssl = Ref<StreamPeerSSL>(StreamPeerSSL::create());
+    if (ssl.is_null())
+    {
+        return false;
+    }
+    ssl->set_blocking_handshake_enabled(false);
+    if (ssl->accept_stream(tcp, key, certificate) != OK)
+    {
+        return false;
+    }
+    uint64_t deadline = OS::get_singleton()->get_ticks_msec() + CRASHPAD_BENCHMARK_REQUEST_TIMEOUT_MSEC;
+    while (ssl->get_status() == StreamPeerSSL::STATUS_HANDSHAKING && exit_requested.is_set() == false && OS::get_singleton()->get_ticks_msec() < deadline)
+    {
+        OS::get_singleton()->delay_usec(100);
+        ssl->poll();
+    }
+    connection = ssl;
+    return ssl->get_status() == StreamPeerSSL::STATUS_CONNECTED;
+}
+
+bool CrashpadBenchmarkSink::_is_connected()
+{
+    if (tcp->get_status() != StreamPeerTCP::STATUS_CONNECTED)
+    {
+        return false;
+    }
+    return ssl.is_null() || ssl->get_status() == StreamPeerSSL::STATUS_CONNECTED;
+}
+
+bool CrashpadBenchmarkSink::_fill_buffer(uint64_t p_deadline)
+{
+    while (exit_requested.is_set() == false && OS::get_singleton()->get_ticks_msec() < p_deadline)
+    {
+        if (_is_connected() == false)
+        {
+            return false;
+        }
+        int received = 0;
+        if (connection->get_partial_data(buffer, sizeof(buffer), received) != OK)
+        {
+            return false;
+        }
+        if (received > 0)
+        {
+            buffer_position = 0;
+            buffer_size = received;
+            return true;
+        }
+        OS::get_singleton()->delay_usec(100);
+    }
+    return false;
+}
+
+bool CrashpadBenchmarkSink::_read_line(String &r_line, uint64_t p_deadline)
+{
+    CharString line;
+    while (true)
+    {
+        if (buffer_position >= buffer_size && _fill_buffer(p_deadline) == false)
+        {
+            return false;
+        }
+        char c = (char)buffer[buffer_position++];
+        if (c == '\n')
+        {
+            break;
+        }
+        if (c != '\r')
+        {
+            if (line.length() >= 8192)
+            {
+                return false;
+            }
+            line += c;
+        }
+    }
+    r_line.parse_utf8(line.get_data(), line.length());
+    return true;
+}
+
+static int64_t _find_crash_time(const Vector<uint8_t> &p_body)
+{
+    String marker = String("name=\"") + CrashpadBenchmark::CRASH_TIME_ANNOTATION + "\"";
+    CharString marker_utf8 = marker.utf8();
+    int marker_length = marker_utf8.length();
+    const uint8_t *data = p_body.ptr();
+    int size = p_body.size();
+
+    for (int i = 0; i + marker_length <= size; i++)
+    {
+        if (memcmp(data + i, marker_utf8.get_data(), marker_length) != 0)
+        {
+            continue;
+        }
+        // The value follows the blank line after the part headers
+        for (int j = i + marker_length; j + 3 < size; j++)
+        {
+            if (data[j] == '\r' && data[j + 1] == '\n' && data[j + 2] == '\r' && data[j + 3] == '\n')
+            {
+                int64_t value = 0;
+                int k = j + 4;
+                if (k >= size || data[k] < '0' || data[k] > '9')
+                {
+                    return -1;
+                }
+                while (k < size && data[k] >= '0' && data[k] <= '9')
+                {
+                    value = value * 10 + (data[k] - '0');
+                    k++;
+                }
+                return value;
+            }
+        }
+        return -1;
+    }
+    return -1;
+}
+
+bool CrashpadBenchmarkSink::_serve_request()
+{
+    uint64_t deadline = OS::get_singleton()->get_ticks_msec() + CRASHPAD_BENCHMARK_REQUEST_TIMEOUT_MSEC;
+
+    String request_line;
+    if (_read_line(request_line, deadline) == false || request_line.empty() == true)
+    {
+        return false;
+    }
+
+    uint64_t content_length = 0;
+    bool keep_alive = true;
+    String line;
+    while (true)
+    {
+        if (_read_line(line, deadline) == false)
+        {
+            return false;
+        }
+        if (line.empty() == true)
+        {
+            break;
+        }
+        String header = line.get_slice(":", 0).strip_edges().to_lower();
+        String value = line.substr(line.find(":") + 1, line.length()).strip_edges();
+        if (header == "content-length")
+        {
+            content_length = value.to_int64();
+        }
+        else if (header == "connection" && value.to_lower() == "close")
+        {
+            keep_alive = false;
+        }
+    }
+
+    Vector<uint8_t> scanned;
+    uint64_t remaining = content_length;
+    while (remaining > 0)
+    {
+        if (buffer_position >= buffer_size && _fill_buffer(deadline) == false)
+        {
+            return false;
+        }
+        int available = MIN((uint64_t)(buffer_size - buffer_position), remaining);
+        int scan_size = MIN(available, CRASHPAD_BENCHMARK_SCAN_SIZE - scanned.size());
+        if (scan_size > 0)
+        {
+            int old_size = scanned.size();
+            scanned.resize(old_size + scan_size);
+            memcpy(scanned.ptrw() + old_size, buffer + buffer_position, scan_size);
+        }
+        buffer_position += available;
+        remaining -= available;
+    }
+
+    int64_t crash_time = _find_crash_time(scanned);
+    mutex.lock();
+    request_count += 1;
+    received_bytes += content_length;
+    if (crash_time >= 0 && crash_received_time_msec < 0)
+    {
+        crash_time_msec = crash_time;
+        crash_received_time_msec = OS::get_singleton()->get_system_time_msecs();
+        crash_received_ticks_msec = OS::get_singleton()->get_ticks_msec();
+    }
+    mutex.unlock();
+
+    const char *response = "HTTP/1.1 200 OK\r\nContent-Length: 0\r\n\r\n";
+    connection->put_data((const uint8_t *)response, strlen(response));
+    return keep_alive;
+}
+
+
+static Error _generate_database(const String &p_database_path, int p_report_count, int p_dump_size)
+{
+    String pending_path = p_database_path.plus_file("pending");
+    DirAccess *dir = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+    Error error = dir->make_dir_recursive(pending_path);
+    memdelete(dir);
+    if (error != OK)
+    {
+        return error;
+    }
+
+    // The content does not matter, but it should not compress to nothing either
+    Vector<uint8_t> dump_data;
+    dump_data.resize(p_dump_size);
+    for (int i = 0; i < p_dump_size; i++)
+    {
+        dump_data.write[i] = Math::rand() & 0xFF;
+    }
+
+    for (int i = 0; i < p_report_count; i++)
+    {
+        String id = "00000000-0000-4000-8000-" + itos(i).pad_zeros(12);
+        FileAccess *file = FileAccess::open(pending_path.plus_file(id + ".dmp"), FileAccess::WRITE);
+        if (file == nullptr)
+        {
+            return ERR_FILE_CANT_WRITE;
+        }
+        file->store_buffer(dump_data.ptr(), dump_data.size());
+        file->close();
+        memdelete(file);
+
+        file = FileAccess::open(pending_path.plus_file(id + ".meta"), FileAccess::WRITE);
+        if (file == nullptr)
+        {
+            return ERR_FILE_CANT_WRITE;
+        }
+        file->store_32(0);
+        file->close();
+        memdelete(file);
+    }
+    return OK;
+}
+
+static double _msec_since(uint64_t p_start_usec)
+{
+    return (OS::get_singleton()->get_ticks_usec() - p_start_usec) / 1000.0;
+}
+
+static Dictionary _benchmark_database(const String &p_database_path, int p_report_count, int p_dump_size, const String &p_sink_url, int p_upload_count)
+{
+    Dictionary result;
+    result["reports"] = p_report_count;
+
+    uint64_t start = OS::get_singleton()->get_ticks_usec();
+    Error error = _generate_database(p_database_path, p_report_count, p_dump_size);
+    result["generate_msec"] = _msec_since(start);
+    if (error != OK)
+    {
+        result["error"] = "Could not generate the database: " + itos(error);
+        return result;
+    }
+
+    // No index yet: this is the first start after the handler wrote all those reports
+    uint64_t memory_before = OS::get_singleton()->get_static_memory_usage();
+    CrashpadReportIndex *index = memnew(CrashpadReportIndex);
+    start = OS::get_singleton()->get_ticks_usec();
+    index->open(p_database_path);
+    index->reconcile();
+    result["index_cold_open_msec"] = _msec_since(start);
+    // Only counted in builds with memory tracking
+    result["index_memory_bytes"] = (int64_t)(OS::get_singleton()->get_static_memory_usage() - memory_before);
+
+    start = OS::get_singleton()->get_ticks_usec();
+    index->save();
+    result["index_save_msec"] = _msec_since(start);
+    memdelete(index);
+
+    // Nothing changed since the index was saved, which is the common start
+    CrashpadReportIndex warm_index;
+    start = OS::get_singleton()->get_ticks_usec();
+    warm_index.open(p_database_path);
+    warm_index.reconcile();
+    result["index_warm_open_msec"] = _msec_since(start);
+
+    if (p_sink_url.empty() == false)
+    {
+        Vector<String> report_ids = warm_index.get_all_report_ids();
+        int upload_count = MIN(p_upload_count, report_ids.size());
+        CrashpadUploader uploader;
+        uint64_t uploaded_bytes = 0;
+        int failed_uploads = 0;
+
+        start = OS::get_singleton()->get_ticks_usec();
+        for (int i = 0; i < upload_count; i++)
+        {
+            CrashpadMultipartBody body;
+            body.add_field("benchmark", "true");
+            body.add_file("upload_file_minidump", warm_index.get_report(report_ids[i]).path, "application/octet-stream");
+            body.finish();
+
+            int response_code = 0;
+            if (uploader.post(p_sink_url, &body, Vector<String>(), response_code) == OK && response_code == 200)
+            {
+                uploaded_bytes += body.get_size();
+            }
+            else
+            {
+                failed_uploads += 1;
+            }
+        }
+        double upload_msec = _msec_since(start);
+        uploader.close();
+
+        result["uploads"] = upload_count;
+        result["failed_uploads"] = failed_uploads;
+        result["upload_msec"] = upload_msec;
+        if (upload_msec > 0.0)
+        {
+            result["upload_bytes_per_second"] = uploaded_bytes * 1000.0 / upload_msec;
+            result["upload_requests_per_second"] = upload_count * 1000.0 / upload_msec;
+        }
+    }
+
+    // Same work as NOTIFICATION_READY when deleting the database on start
+    start = OS::get_singleton()->get_ticks_usec();
+    warm_index.remove_all_reports();
+    warm_index.save();
+    result["cleanup_msec"] = _msec_since(start);
+
+    DirAccess::remove_file_or_error(p_database_path.plus_file("godot_report_index.dat"));
+    return result;
+}
+
+static Dictionary _benchmark_https(int p_port, int p_upload_count)
+{
+    Dictionary result;
+    Crypto *crypto = Crypto::create();
+    if (crypto == nullptr)
+    {
+        result["error"] = "This build has no TLS support.";
+        return result;
+    }
+    // A certificate for the address the uploader connects to, trusted by the uploader only
+    Ref<CryptoKey> key = crypto->generate_rsa(2048);
+    Ref<X509Certificate> certificate = crypto->generate_self_signed_certificate(key, "CN=127.0.0.1,O=Godot,C=US");
+    memdelete(crypto);
+    if (key.is_null() || certificate.is_null())
+    {
+        result["error"] = "Could not make a test certificate.";
+        return result;
+    }
+
+    CrashpadBenchmarkSink sink;
+    if (sink.start(p_port, key, certificate) != OK)
+    {
+        result["error"] = "Could not start the HTTPS sink on port " + itos(p_port) + ".";
+        return result;
+    }
+    String url = "https://127.0.0.1:" + itos(p_port) + "/";
+
+    CrashpadUploader uploader;
+    uploader.trusted_certificate = certificate;
+    int failed_uploads = 0;
+    uint64_t start = OS::get_singleton()->get_ticks_usec();
+    for (int i = 0; i < p_upload_count; i++)
+    {
+        CrashpadMemoryBody body;
+        body.set_data(String("{\"benchmark\": true}").utf8(), "application/json");
+        int response_code = 0;
+        if (uploader.post(url, &body, Vector<String>(), response_code) != OK || response_code != 200)
+        {
+            failed_uploads += 1;
+        }
+    }
+    double upload_msec = _msec_since(start);
+    uploader.close();
+    sink.stop();
+
+    result["uploads"] = p_upload_count;
+    result["failed_uploads"] = failed_uploads;
+    // The first one includes the handshake, the others reuse the connection
+    result["upload_msec"] = upload_msec;
+    if (p_upload_count > 0 && failed_uploads == p_upload_count)
+    {
+        result["error"] = "No upload over HTTPS succeeded.";
+    }
+
+    // A server that takes the connection but never answers the handshake must not hold the uploader past its connect timeout.
+    // Nothing ever accepts from this one, the system completes the TCP connection by itself.
+    Ref<TCP_Server> stalled_server;
+    stalled_server.instance();
+    if (stalled_server->listen(p_port + 1, IP_Address("127.0.0.1")) == OK)
+    {
+        CrashpadUploader stalled_uploader;
+        stalled_uploader.connect_timeout_msec = CRASHPAD_BENCHMARK_STALL_TIMEOUT_MSEC;
+        CrashpadMemoryBody body;
+        body.set_data(String("{}").utf8(), "application/json");
+        int response_code = 0;
+        start = OS::get_singleton()->get_ticks_usec();
+        Error error = stalled_uploader.post("https://127.0.0.1:" + itos(p_port + 1) + "/", &body, Vector<String>(), response_code);
+        double stalled_msec = _msec_since(start);
+        stalled_server->stop();
+
+        result["stalled_handshake_msec"] = stalled_msec;
+        if (error != ERR_TIMEOUT || stalled_msec > CRASHPAD_BENCHMARK_STALL_TIMEOUT_MSEC * 2)
+        {
+            result["error"] = "A stalled TLS handshake was not timed out (error " + itos(error) + ").";
+        }
+    }
+    return result;
+}
+
+static Dictionary _benchmark_crash_child(CrashpadBenchmarkSink &p_sink, const String &p_sink_url, const Array &p_child_arguments, int p_timeout_msec)
+{
+    Dictionary result;
+#ifndef DEBUG_ENABLED
+    // Release builds ignore the benchmark arguments, so the child would neither crash nor report to the sink
+    result["error"] = "The crash child needs a debug build.";
+    return result;
+#else
+
+    List<String> arguments;
+    arguments.push_back("--path");
+    arguments.push_back(ProjectSettings::get_singleton()->get_resource_path());
+    for (int i = 0; i < p_child_arguments.size(); i++)
+    {
+        arguments.push_back((String)p_child_arguments[i]);
+    }
+    arguments.push_back(CrashpadBenchmark::CRASH_ARGUMENT);
+    arguments.push_back(String(CrashpadBenchmark::URL_ARGUMENT) + p_sink_url);
+
+    uint64_t spawn_ticks = OS::get_singleton()->get_ticks_msec();
+    OS::ProcessID child_id = 0;
+    Error error = OS::get_singleton()->execute(OS::get_singleton()->get_executable_path(), arguments, false, &child_id);
+    if (error != OK)
+    {
+        result["error"] = "Could not start the child process: " + itos(error);
+        return result;
+    }
+
+    int64_t crash_time = -1;
+    int64_t received_time = -1;
+    uint64_t received_ticks = 0;
+    while (p_sink.get_crash(crash_time, received_time, received_ticks) == false)
+    {
+        if (OS::get_singleton()->get_ticks_msec() - spawn_ticks > (uint64_t)p_timeout_msec)
+        {
+            result["error"] = "The child's crash report did not arrive in time.";
+            OS::get_singleton()->kill(child_id);
+            return result;
+        }
+        OS::get_singleton()->delay_usec(1000);
+    }
+
+    // Includes starting the engine and the project, so it is mostly useful to compare runs
+    result["spawn_to_server_msec"] = (int64_t)(received_ticks - spawn_ticks);
+    // Both times are wall clock times of the same machine
+    result["crash_to_server_msec"] = received_time - crash_time;
+    return result;
+#endif
+}
+
+Dictionary CrashpadBenchmark::run(const Dictionary &p_options)
+{
+    Dictionary results;
+
+    Array report_counts;
+    if (p_options.has("report_counts"))
+    {
+        report_counts = p_options["report_counts"];
+    }
+    else
+    {
+        report_counts.push_back(10);
+        report_counts.push_back(1000);
+        report_counts.push_back(10000);
+    }
+    int dump_size = p_options.has("dump_size") ? (int)p_options["dump_size"] : 4096;
+    String work_path = p_options.has("work_path") ? (String)p_options["work_path"] : "user://crashpad_benchmark";
+    int sink_port = p_options.has("sink_port") ? (int)p_options["sink_port"] : 18080;
+    int upload_count = p_options.has("upload_count") ? (int)p_options["upload_count"] : 100;
+    int https_upload_count = p_options.has("https_upload_count") ? (int)p_options["https_upload_count"] : 10;
+    bool crash_child = p_options.has("crash_child") ? (bool)p_options["crash_child"] : false;
+    Array child_arguments = p_options.has("child_arguments") ? (Array)p_options["child_arguments"] : Array();
+    int crash_timeout = p_options.has("crash_timeout_msec") ? (int)p_options["crash_timeout_msec"] : 30000;
+
+    work_path = ProjectSettings::get_singleton()->globalize_path(work_path);
+
+    CrashpadBenchmarkSink sink;
+    String sink_url;
+    if (sink.start(sink_port) == OK)
+    {
+        sink_url = "http://127.0.0.1:" + itos(sink_port) + "/";
+    }
+    else
+    {
+        WARN_PRINT("Could not start the benchmark HTTP sink on port " + itos(sink_port) + ", skipping the upload benchmarks.");
+    }
+
+    Array databases;
+    for (int i = 0; i < report_counts.size(); i++)
+    {
+        int report_count = report_counts[i];
+        databases.push_back(_benchmark_database(work_path.plus_file("db_" + itos(report_count)), report_count, dump_size, sink_url, upload_count));
+    }
+    results["databases"] = databases;
+
+    if (https_upload_count > 0)
+    {
+        results["https"] = _benchmark_https(sink_port + 1, https_upload_count);
+    }
+
+    if (crash_child == true && sink_url.empty() == false)
+    {
+        results["crash"] = _benchmark_crash_child(sink, sink_url, child_arguments, crash_timeout);
+    }
+
+    if (sink_url.empty() == false)
+    {
+        int request_count = 0;
+        uint64_t received_bytes = 0;
+        sink.get_counters(request_count, received_bytes);
+        results["sink_requests"] = request_count;
+        results["sink_received_bytes"] = received_bytes;
+    }
+    sink.stop();
+    return results;
+}
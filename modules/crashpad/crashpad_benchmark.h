@@ -0,0 +1,35 @@
+/* crashpad_benchmark.h */
+
+#ifndef CRASHPAD_BENCHMARK_H
+#define CRASHPAD_BENCHMARK_H
+
+#include "core/dictionary.h"
+#include "core/ustring.h"
+
+// Measures what the crash reporting pipeline costs, without needing a crash server.
+// A small HTTP sink is started on localhost, synthetic databases are generated, and the
+// report index, the uploader and (optionally) a real crash in a child process are timed against it.
+// Meant to be run headless, e.g. from a script started with "godot --no-window -s".
+class CrashpadBenchmark {
+public:
+    // Child processes started with these arguments send their crash to the given URL and crash right after start_crashpad()
+    static const char *CRASH_ARGUMENT;
+    static const char *URL_ARGUMENT;
+    // The child puts the time it crashed in this annotation, so the sink can work out the crash to server time
+    static const char *CRASH_TIME_ANNOTATION;
+
+    // Options (all optional):
+    //   "report_counts": Array of database sizes to generate, default [10, 1000, 10000]
+    //   "dump_size": size of each synthetic dump in bytes, default 4096
+    //   "work_path": where the databases are generated, default "user://crashpad_benchmark"
+    //   "sink_port": localhost port of the HTTP sink, default 18080
+    //   "upload_count": how many dumps of each database are uploaded to the sink, default 100
+    //   "https_upload_count": how many small reports are uploaded to a second, HTTPS sink on sink_port + 1, default 10.
+    //       A server that stalls the TLS handshake is then started on sink_port + 2, and must be timed out. 0 skips both.
+    //   "crash_child": start a child process of this project that calls force_crash(), default false
+    //   "child_arguments": Array of extra command line arguments for the child
+    //   "crash_timeout_msec": how long to wait for the child's crash to arrive, default 30000
+    static Dictionary run(const Dictionary &p_options);
+};
+
+#endif // CRASHPAD_BENCHMARK_H
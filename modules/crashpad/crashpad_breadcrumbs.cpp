@@ -0,0 +1,131 @@
+/* crashpad_breadcrumbs.cpp */
+
+#include "crashpad_breadcrumbs.h"
+#include "core/os/os.h"
+#include "crashpad_string_utils.h"
+
+CrashpadBreadcrumbs::Slot CrashpadBreadcrumbs::slots[CrashpadBreadcrumbs::CAPACITY];
+std::atomic<uint64_t> CrashpadBreadcrumbs::next_index(0);
+
+
+void CrashpadBreadcrumbs::_copy_string(char *r_buffer, int p_size, const char *p_string)
+{
+    int position = 0;
+    while (p_string[position] != '\0' && position < p_size - 1)
+    {
+        r_buffer[position] = p_string[position];
+        position++;
+    }
+    r_buffer[position] = '\0';
+}
+
+void CrashpadBreadcrumbs::_add(uint64_t p_time_msec, const char *p_category, const String *p_category_string, const char *p_message, const String *p_message_string)
+{
+    uint64_t index = next_index.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots[index & (CAPACITY - 1)];
+
+    // Mark the slot as being written, so readers skip it instead of reading a torn breadcrumb
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.time_msec = p_time_msec;
+    // Encode to UTF-8 straight into the slot, without going through a temporary CharString
+    if (p_category_string != nullptr)
+    {
+        CrashpadStringUtils::copy_utf8(slot.category, CATEGORY_SIZE, *p_category_string);
+    }
+    else
+    {
+        _copy_string(slot.category, CATEGORY_SIZE, p_category);
+    }
+    if (p_message_string != nullptr)
+    {
+        CrashpadStringUtils::copy_utf8(slot.message, MESSAGE_SIZE, *p_message_string);
+    }
+    else
+    {
+        _copy_string(slot.message, MESSAGE_SIZE, p_message);
+    }
+
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+}
+
+void CrashpadBreadcrumbs::add(const String &p_category, const String &p_message)
+{
+    _add(OS::get_singleton()->get_ticks_msec(), nullptr, &p_category, nullptr, &p_message);
+}
+
+void CrashpadBreadcrumbs::add(const char *p_category, const char *p_message)
+{
+    _add(OS::get_singleton()->get_ticks_msec(), p_category, nullptr, p_message, nullptr);
+}
+
+void CrashpadBreadcrumbs::clear()
+{
+    // A sequence of 0 never matches a written breadcrumb, so readers skip the slot
+    for (int i = 0; i < CAPACITY; i++)
+    {
+        slots[i].sequence.store(0, std::memory_order_release);
+    }
+}
+
+int CrashpadBreadcrumbs::write_text(char *r_buffer, int p_size, Snapshot *r_snapshots)
+{
+    // Take a consistent copy of each slot first, newest to oldest
+    uint64_t end = next_index.load(std::memory_order_acquire);
+    uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+    int snapshot_count = 0;
+    for (uint64_t index = end; index > begin; index--)
+    {
+        const Slot &slot = slots[(index - 1) & (CAPACITY - 1)];
+        uint64_t expected_sequence = 2 * (index - 1) + 2;
+        if (slot.sequence.load(std::memory_order_acquire) != expected_sequence)
+        {
+            continue;
+        }
+        Snapshot &snapshot = r_snapshots[snapshot_count];
+        snapshot.time_msec = slot.time_msec;
+        memcpy(snapshot.category, slot.category, CATEGORY_SIZE);
+        memcpy(snapshot.message, slot.message, MESSAGE_SIZE);
+        snapshot.category[CATEGORY_SIZE - 1] = '\0';
+        snapshot.message[MESSAGE_SIZE - 1] = '\0';
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // Overwritten while we copied it
+        if (slot.sequence.load(std::memory_order_relaxed) != expected_sequence)
+        {
+            continue;
+        }
+        snapshot_count++;
+    }
+
+    // Find how many of the newest breadcrumbs fit
+    int fitting = 0;
+    int total_length = 0;
+    while (fitting < snapshot_count)
+    {
+        const Snapshot &snapshot = r_snapshots[fitting];
+        // "[" time "] " category ": " message "\n"
+        int line_length = 1 + CrashpadStringUtils::get_number_length(snapshot.time_msec) + 2 + strlen(snapshot.category) + 2 + strlen(snapshot.message) + 1;
+        if (total_length + line_length > p_size)
+        {
+            break;
+        }
+        total_length += line_length;
+        fitting++;
+    }
+
+    // Write them oldest first
+    int position = 0;
+    for (int i = fitting - 1; i >= 0; i--)
+    {
+        const Snapshot &snapshot = r_snapshots[i];
+        position = CrashpadStringUtils::write_text(r_buffer, position, p_size, "[");
+        position = CrashpadStringUtils::write_number(r_buffer, position, p_size, snapshot.time_msec);
+        position = CrashpadStringUtils::write_text(r_buffer, position, p_size, "] ");
+        position = CrashpadStringUtils::write_text(r_buffer, position, p_size, snapshot.category);
+        position = CrashpadStringUtils::write_text(r_buffer, position, p_size, ": ");
+        position = CrashpadStringUtils::write_text(r_buffer, position, p_size, snapshot.message);
+        position = CrashpadStringUtils::write_text(r_buffer, position, p_size, "\n");
+    }
+    return position;
+}
@@ -0,0 +1,55 @@
+/* crashpad_breadcrumbs.h */
+
+#ifndef CRASHPAD_BREADCRUMBS_H
+#define CRASHPAD_BREADCRUMBS_H
+
+#include "core/ustring.h"
+
+#include <atomic>
+
+// A fixed size, lock-free ring of the most recent breadcrumbs (short category + message records).
+// Any thread can add breadcrumbs at a high rate: adding one is an atomic increment and a few copies
+// into preallocated storage. At crash time the ring is written out as text, oldest first.
+class CrashpadBreadcrumbs {
+public:
+    enum {
+        CAPACITY = 256, // Must be a power of two
+        CATEGORY_SIZE = 32,
+        MESSAGE_SIZE = 216,
+    };
+
+private:
+    struct Slot {
+        // Odd while the slot is being written, otherwise 2 * (index + 1) of the breadcrumb in it
+        std::atomic<uint64_t> sequence;
+        uint64_t time_msec;
+        char category[CATEGORY_SIZE];
+        char message[MESSAGE_SIZE];
+    };
+
+    static Slot slots[CAPACITY];
+    static std::atomic<uint64_t> next_index;
+
+    static void _copy_string(char *r_buffer, int p_size, const char *p_string);
+    static void _add(uint64_t p_time_msec, const char *p_category, const String *p_category_string, const char *p_message, const String *p_message_string);
+
+public:
+    // A consistent copy of one slot. write_text() needs CAPACITY of them as scratch space.
+    struct Snapshot {
+        uint64_t time_msec;
+        char category[CATEGORY_SIZE];
+        char message[MESSAGE_SIZE];
+    };
+
+    static void add(const String &p_category, const String &p_message);
+    static void add(const char *p_category, const char *p_message);
+    static void clear();
+
+    // Writes the breadcrumbs as "[time_msec] category: message" lines, oldest first, dropping the
+    // oldest ones if they do not fit. Returns the number of bytes written (no null terminator).
+    // Does not allocate or lock, so it can run inside a crash handler. r_snapshots (CAPACITY of them) belongs
+    // to the caller, so several threads can write the breadcrumbs at once (e.g. a hang report and a crash).
+    static int write_text(char *r_buffer, int p_size, Snapshot *r_snapshots);
+};
+
+#endif // CRASHPAD_BREADCRUMBS_H
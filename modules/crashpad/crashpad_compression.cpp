@@ -0,0 +1,154 @@
+/* crashpad_compression.cpp */
+
+#include "crashpad_compression.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+
+#include <zlib.h>
+#include <zstd.h>
+
+#define CRASHPAD_COMPRESSION_CHUNK_SIZE 16384
+
+
+String CrashpadCompression::get_content_encoding(Mode p_mode)
+{
+    switch (p_mode)
+    {
+        case MODE_GZIP:
+            return "gzip";
+        case MODE_ZSTD:
+            return "zstd";
+        default:
+            return "";
+    }
+}
+
+static Error _compress_gzip(CrashpadUploadBody *p_body, FileAccess *p_target)
+{
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    // 15 window bits, plus 16 to write a gzip header instead of a zlib one
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+    {
+        return ERR_CANT_CREATE;
+    }
+
+    uint8_t in_buffer[CRASHPAD_COMPRESSION_CHUNK_SIZE];
+    uint8_t out_buffer[CRASHPAD_COMPRESSION_CHUNK_SIZE];
+    Error error = OK;
+    int flush = Z_NO_FLUSH;
+    while (flush != Z_FINISH)
+    {
+        int read = p_body->read(in_buffer, CRASHPAD_COMPRESSION_CHUNK_SIZE);
+        if (read < 0)
+        {
+            error = ERR_FILE_CANT_READ;
+            break;
+        }
+        flush = read == 0 ? Z_FINISH : Z_NO_FLUSH;
+        stream.next_in = in_buffer;
+        stream.avail_in = read;
+
+        do
+        {
+            stream.next_out = out_buffer;
+            stream.avail_out = CRASHPAD_COMPRESSION_CHUNK_SIZE;
+            int result = deflate(&stream, flush);
+            if (result == Z_STREAM_ERROR)
+            {
+                error = ERR_BUG;
+                break;
+            }
+            p_target->store_buffer(out_buffer, CRASHPAD_COMPRESSION_CHUNK_SIZE - stream.avail_out);
+        } while (stream.avail_out == 0);
+
+        if (error != OK)
+        {
+            break;
+        }
+    }
+    deflateEnd(&stream);
+    return error;
+}
+
+static Error _compress_zstd(CrashpadUploadBody *p_body, FileAccess *p_target)
+{
+    ZSTD_CCtx *context = ZSTD_createCCtx();
+    if (context == nullptr)
+    {
+        return ERR_CANT_CREATE;
+    }
+    ZSTD_CCtx_setParameter(context, ZSTD_c_compressionLevel, 3);
+    // Keep the window small, so the memory used does not grow with the body
+    ZSTD_CCtx_setParameter(context, ZSTD_c_windowLog, 20);
+
+    uint8_t in_buffer[CRASHPAD_COMPRESSION_CHUNK_SIZE];
+    uint8_t out_buffer[CRASHPAD_COMPRESSION_CHUNK_SIZE];
+    Error error = OK;
+    bool finished = false;
+    while (finished == false)
+    {
+        int read = p_body->read(in_buffer, CRASHPAD_COMPRESSION_CHUNK_SIZE);
+        if (read < 0)
+        {
+            error = ERR_FILE_CANT_READ;
+            break;
+        }
+        ZSTD_EndDirective mode = read == 0 ? ZSTD_e_end : ZSTD_e_continue;
+        ZSTD_inBuffer input = { in_buffer, (size_t)read, 0 };
+
+        bool chunk_done = false;
+        while (chunk_done == false)
+        {
+            ZSTD_outBuffer output = { out_buffer, CRASHPAD_COMPRESSION_CHUNK_SIZE, 0 };
+            size_t remaining = ZSTD_compressStream2(context, &output, &input, mode);
+            if (ZSTD_isError(remaining))
+            {
+                error = ERR_BUG;
+                break;
+            }
+            p_target->store_buffer(out_buffer, output.pos);
+            // When finishing, zstd tells how much is left to flush. Otherwise it is done once the input is used up.
+            chunk_done = mode == ZSTD_e_end ? remaining == 0 : input.pos == input.size;
+        }
+        if (error != OK)
+        {
+            break;
+        }
+        finished = mode == ZSTD_e_end;
+    }
+    ZSTD_freeCCtx(context);
+    return error;
+}
+
+Error CrashpadCompression::compress_to_file(CrashpadUploadBody *p_body, const String &p_target_path, Mode p_mode)
+{
+    ERR_FAIL_NULL_V(p_body, ERR_INVALID_PARAMETER);
+    ERR_FAIL_COND_V(p_mode == MODE_NONE, ERR_INVALID_PARAMETER);
+
+    FileAccess *target = FileAccess::open(p_target_path, FileAccess::WRITE);
+    if (target == nullptr)
+    {
+        return ERR_FILE_CANT_WRITE;
+    }
+
+    Error error = p_body->open();
+    if (error == OK)
+    {
+        error = p_mode == MODE_GZIP ? _compress_gzip(p_body, target) : _compress_zstd(p_body, target);
+    }
+    p_body->close();
+
+    if (error == OK && target->get_error() != OK)
+    {
+        error = ERR_FILE_CANT_WRITE;
+    }
+    target->close();
+    memdelete(target);
+
+    if (error != OK)
+    {
+        DirAccess::remove_file_or_error(p_target_path);
+    }
+    return error;
+}
@@ -0,0 +1,24 @@
+/* crashpad_compression.h */
+
+#ifndef CRASHPAD_COMPRESSION_H
+#define CRASHPAD_COMPRESSION_H
+
+#include "core/ustring.h"
+#include "crashpad_uploader.h"
+
+// Streaming compression of upload bodies. The body is compressed chunk by chunk
+// into a file, so memory use does not depend on the size of the dump or the log.
+class CrashpadCompression {
+public:
+    enum Mode {
+        MODE_NONE,
+        MODE_GZIP,
+        MODE_ZSTD,
+    };
+
+    // The value for the Content-Encoding header
+    static String get_content_encoding(Mode p_mode);
+    static Error compress_to_file(CrashpadUploadBody *p_body, const String &p_target_path, Mode p_mode);
+};
+
+#endif // CRASHPAD_COMPRESSION_H
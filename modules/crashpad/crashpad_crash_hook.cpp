@@ -0,0 +1,114 @@
+/* crashpad_crash_hook.cpp */
+
+#include "crashpad_crash_hook.h"
+#include "core/error_macros.h"
+#include "crashpad_platform.h"
+
+#if defined WINDOWS_ENABLED
+// Needed to avoid compiling/linking issues on Windows
+#define NOMINMAX
+#include <windows.h>
+#elif defined CRASHPAD_LINUX_ENABLED && defined __linux__
+#include "crashpad/client/crashpad_client.h"
+#endif
+
+CrashpadCrashHook::Callback CrashpadCrashHook::callbacks[CrashpadCrashHook::MAX_CALLBACKS] = {};
+void *CrashpadCrashHook::callback_userdata[CrashpadCrashHook::MAX_CALLBACKS] = {};
+int CrashpadCrashHook::callback_count = 0;
+bool CrashpadCrashHook::installed = false;
+
+
+#if defined WINDOWS_ENABLED
+static LONG WINAPI _crashpad_vectored_exception_handler(EXCEPTION_POINTERS *p_exception_info)
+{
+    // Vectored handlers see every exception first, so only react to the ones that end the process
+    switch (p_exception_info->ExceptionRecord->ExceptionCode)
+    {
+        case EXCEPTION_ACCESS_VIOLATION:
+        case EXCEPTION_ARRAY_BOUNDS_EXCEEDED:
+        case EXCEPTION_DATATYPE_MISALIGNMENT:
+        case EXCEPTION_FLT_DIVIDE_BY_ZERO:
+        case EXCEPTION_ILLEGAL_INSTRUCTION:
+        case EXCEPTION_IN_PAGE_ERROR:
+        case EXCEPTION_INT_DIVIDE_BY_ZERO:
+        case EXCEPTION_PRIV_INSTRUCTION:
+        case EXCEPTION_STACK_OVERFLOW:
+            CrashpadCrashHook::run_callbacks();
+            break;
+        default:
+            break;
+    }
+    return EXCEPTION_CONTINUE_SEARCH;
+}
+#elif defined CRASHPAD_LINUX_ENABLED && defined __linux__
+static bool _crashpad_first_chance_handler(int p_signal, siginfo_t *p_info, ucontext_t *p_context)
+{
+    CrashpadCrashHook::run_callbacks();
+    // Not handled, so Crashpad goes on and writes the dump
+    return false;
+}
+#endif
+
+bool CrashpadCrashHook::is_supported()
+{
+#if defined WINDOWS_ENABLED || (defined CRASHPAD_LINUX_ENABLED && defined __linux__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool CrashpadCrashHook::install()
+{
+    if (installed == true)
+    {
+        return true;
+    }
+#if defined WINDOWS_ENABLED
+    installed = AddVectoredExceptionHandler(1, _crashpad_vectored_exception_handler) != NULL;
+#elif defined CRASHPAD_LINUX_ENABLED && defined __linux__
+    crashpad::CrashpadClient::SetFirstChanceExceptionHandler(_crashpad_first_chance_handler);
+    installed = true;
+#endif
+    return installed;
+}
+
+void CrashpadCrashHook::add_callback(Callback p_callback, void *p_userdata)
+{
+    for (int i = 0; i < callback_count; i++)
+    {
+        if (callbacks[i] == p_callback && callback_userdata[i] == p_userdata)
+        {
+            return;
+        }
+    }
+    ERR_FAIL_COND(callback_count >= MAX_CALLBACKS);
+    callback_userdata[callback_count] = p_userdata;
+    callbacks[callback_count] = p_callback;
+    callback_count++;
+}
+
+void CrashpadCrashHook::remove_callback(Callback p_callback, void *p_userdata)
+{
+    for (int i = 0; i < callback_count; i++)
+    {
+        if (callbacks[i] == p_callback && callback_userdata[i] == p_userdata)
+        {
+            for (int j = i; j < callback_count - 1; j++)
+            {
+                callbacks[j] = callbacks[j + 1];
+                callback_userdata[j] = callback_userdata[j + 1];
+            }
+            callback_count--;
+            return;
+        }
+    }
+}
+
+void CrashpadCrashHook::run_callbacks()
+{
+    for (int i = 0; i < callback_count; i++)
+    {
+        callbacks[i](callback_userdata[i]);
+    }
+}
@@ -0,0 +1,33 @@
+/* crashpad_crash_hook.h */
+
+#ifndef CRASHPAD_CRASH_HOOK_H
+#define CRASHPAD_CRASH_HOOK_H
+
+// Runs callbacks on the crashing thread right before the Crashpad handler captures the dump.
+// This is used to copy in-memory data (log tail, breadcrumbs...) into Crashpad annotations,
+// which the handler then reads out of the crashed process.
+// Callbacks run inside a signal or exception handler: they must not allocate or lock.
+// Supported on Windows (vectored exception handler) and Linux (Crashpad first chance handler).
+class CrashpadCrashHook {
+public:
+    typedef void (*Callback)(void *p_userdata);
+
+private:
+    enum {
+        MAX_CALLBACKS = 16,
+    };
+    static Callback callbacks[MAX_CALLBACKS];
+    static void *callback_userdata[MAX_CALLBACKS];
+    static int callback_count;
+    static bool installed;
+
+public:
+    static bool install();
+    static bool is_supported();
+    // Adding the same callback twice does nothing.
+    static void add_callback(Callback p_callback, void *p_userdata);
+    static void remove_callback(Callback p_callback, void *p_userdata);
+    static void run_callbacks();
+};
+
+#endif // CRASHPAD_CRASH_HOOK_H
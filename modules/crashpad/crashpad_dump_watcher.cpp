@@ -0,0 +1,193 @@
+/* crashpad_dump_watcher.cpp */
+
+#include "crashpad_dump_watcher.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+
+#ifdef __linux__
+#include <errno.h>
+#include <limits.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+
+Error CrashpadDumpWatcher::start(const String &p_database_path)
+{
+    stop();
+
+    pending_path = p_database_path.plus_file("pending");
+    // The handler only creates the database folders when it first writes a report
+    if (DirAccess::exists(pending_path) == false)
+    {
+        DirAccess *d = DirAccess::create_for_path(pending_path);
+        Error error = d->make_dir_recursive(pending_path);
+        memdelete(d);
+        if (error != OK)
+        {
+            return error;
+        }
+    }
+
+#ifdef __linux__
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd == -1)
+    {
+        return ERR_CANT_CREATE;
+    }
+    inotify_watch = inotify_add_watch(inotify_fd, pending_path.utf8().get_data(), IN_MOVED_TO);
+    if (inotify_watch == -1)
+    {
+        ::close(inotify_fd);
+        inotify_fd = -1;
+        return ERR_CANT_OPEN;
+    }
+#else
+    pending_dump_count = _count_pending_dumps();
+#endif
+
+    watching = true;
+    return OK;
+}
+
+void CrashpadDumpWatcher::stop()
+{
+#ifdef __linux__
+    if (inotify_fd != -1)
+    {
+        ::close(inotify_fd);
+    }
+    inotify_fd = -1;
+    inotify_watch = -1;
+#endif
+    watching = false;
+}
+
+Error CrashpadDumpWatcher::wait_for_dump(int p_timeout_msec, Vector<String> &r_completed_dumps)
+{
+    ERR_FAIL_COND_V(watching == false, ERR_UNCONFIGURED);
+
+    uint64_t deadline = OS::get_singleton()->get_ticks_msec() + p_timeout_msec;
+
+#ifdef __linux__
+    // Large enough for several events with file names
+    char event_buffer[16 * (sizeof(struct inotify_event) + NAME_MAX + 1)] __attribute__((aligned(__alignof__(struct inotify_event))));
+    // Dumps moved into "pending/" whose lock may still be held
+    Vector<String> moved_dumps;
+
+    while (r_completed_dumps.empty())
+    {
+        for (int i = moved_dumps.size() - 1; i >= 0; i--)
+        {
+            if (_is_dump_complete(moved_dumps[i]) == true)
+            {
+                r_completed_dumps.push_back(moved_dumps[i]);
+                moved_dumps.remove(i);
+            }
+        }
+        if (r_completed_dumps.empty() == false)
+        {
+            break;
+        }
+
+        uint64_t now = OS::get_singleton()->get_ticks_msec();
+        if (now >= deadline)
+        {
+            return ERR_TIMEOUT;
+        }
+
+        // Lock removal is not watched, so only wait a little while a moved dump is still locked
+        int wait_msec = moved_dumps.empty() ? (int)(deadline - now) : MIN((int)(deadline - now), 5);
+        struct pollfd poll_fd;
+        poll_fd.fd = inotify_fd;
+        poll_fd.events = POLLIN;
+        poll_fd.revents = 0;
+        int poll_result = poll(&poll_fd, 1, wait_msec);
+        if (poll_result == -1 && errno != EINTR)
+        {
+            return ERR_CANT_ACQUIRE_RESOURCE;
+        }
+        if (poll_result <= 0)
+        {
+            continue;
+        }
+
+        ssize_t length = read(inotify_fd, event_buffer, sizeof(event_buffer));
+        if (length <= 0)
+        {
+            continue;
+        }
+
+        for (char *ptr = event_buffer; ptr < event_buffer + length;)
+        {
+            const struct inotify_event *event = (const struct inotify_event *)ptr;
+            ptr += sizeof(struct inotify_event) + event->len;
+
+            if (event->len == 0)
+            {
+                continue;
+            }
+            // The ".meta" is written before the ".dmp" is moved in, so only the move counts
+            String file_name = String::utf8(event->name);
+            if (file_name.ends_with(".dmp"))
+            {
+                moved_dumps.push_back(pending_path.plus_file(file_name));
+            }
+        }
+    }
+    return OK;
+#else
+    // No file system notifications here, so check the pending folder for new complete dumps
+    while (_count_pending_dumps() <= pending_dump_count)
+    {
+        if (OS::get_singleton()->get_ticks_msec() >= deadline)
+        {
+            return ERR_TIMEOUT;
+        }
+        OS::get_singleton()->delay_usec(5000);
+    }
+    pending_dump_count = _count_pending_dumps();
+    return OK;
+#endif
+}
+
+bool CrashpadDumpWatcher::_is_dump_complete(const String &p_dump_path) const
+{
+    return FileAccess::exists(p_dump_path) == true && FileAccess::exists(p_dump_path.get_basename() + ".lock") == false;
+}
+
+#ifndef __linux__
+int CrashpadDumpWatcher::_count_pending_dumps()
+{
+    DirAccess *dir = DirAccess::open(pending_path);
+    if (dir == nullptr)
+    {
+        return 0;
+    }
+    int count = 0;
+    dir->list_dir_begin();
+    String file_name = dir->get_next();
+    while (file_name != "")
+    {
+        if (dir->current_is_dir() == false && file_name.ends_with(".dmp") && _is_dump_complete(pending_path.plus_file(file_name)) == true)
+        {
+            count += 1;
+        }
+        file_name = dir->get_next();
+    }
+    dir->list_dir_end();
+    memdelete(dir);
+    return count;
+}
+#endif
+
+CrashpadDumpWatcher::CrashpadDumpWatcher()
+{
+}
+
+CrashpadDumpWatcher::~CrashpadDumpWatcher()
+{
+    stop();
+}
@@ -0,0 +1,42 @@
+/* crashpad_dump_watcher.h */
+
+#ifndef CRASHPAD_DUMP_WATCHER_H
+#define CRASHPAD_DUMP_WATCHER_H
+
+#include "core/ustring.h"
+#include "core/vector.h"
+
+// Waits for the Crashpad handler to finish writing a dump into the database.
+// The handler writes the dump into "new/". To finish it, it takes "pending/<id>.lock", writes
+// "pending/<id>.meta", moves the ".dmp" from "new/" into "pending/" and then removes the lock.
+// So a dump is complete once its ".dmp" is in "pending/" and its ".lock" is gone.
+// On Linux the move is seen with inotify, so the wait ends as soon as the handler is done.
+class CrashpadDumpWatcher {
+    String pending_path;
+    bool watching = false;
+
+#ifdef __linux__
+    int inotify_fd = -1;
+    int inotify_watch = -1;
+#else
+    int pending_dump_count = 0;
+    int _count_pending_dumps();
+#endif
+
+    bool _is_dump_complete(const String &p_dump_path) const;
+
+public:
+    // Must be called before the crash happens, so no completion event is missed.
+    Error start(const String &p_database_path);
+    void stop();
+    bool is_watching() const { return watching; }
+
+    // Blocks until at least one dump has been completed or the timeout is reached.
+    // r_completed_dumps gets the paths of the completed ".dmp" files that were seen.
+    Error wait_for_dump(int p_timeout_msec, Vector<String> &r_completed_dumps);
+
+    CrashpadDumpWatcher();
+    ~CrashpadDumpWatcher();
+};
+
+#endif // CRASHPAD_DUMP_WATCHER_H
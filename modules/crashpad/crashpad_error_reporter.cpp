@@ -0,0 +1,293 @@
+/* crashpad_error_reporter.cpp */
+
+#include "crashpad_error_reporter.h"
+#include "core/io/json.h"
+#include "core/os/os.h"
+#include "crashpad_annotations.h"
+
+// How often the worker checks if a flush is due
+#define CRASHPAD_ERROR_REPORTER_POLL_USEC 100000
+// Distinct errors kept between flushes, anything past this is only counted
+#define CRASHPAD_ERROR_REPORTER_MAX_ERRORS 1000
+// Time the last flush gets when the game quits, for all of its requests together
+#define CRASHPAD_ERROR_REPORTER_EXIT_FLUSH_MSEC 3000
+
+
+void CrashpadErrorReporter::set_timeouts(int p_connect_timeout_msec, int p_total_timeout_msec)
+{
+    connect_timeout_msec = p_connect_timeout_msec;
+    total_timeout_msec = p_total_timeout_msec;
+    uploader.connect_timeout_msec = p_connect_timeout_msec;
+    uploader.total_timeout_msec = p_total_timeout_msec;
+}
+
+void CrashpadErrorReporter::start(const String &p_report_url, const Dictionary &p_attributes, bool p_capture_engine_errors)
+{
+    stop();
+
+    report_url = p_report_url;
+    attributes = p_attributes.duplicate();
+
+    exit_requested.clear();
+    cancelled.clear();
+    flush_requested.clear();
+    uploader.reset_cancel();
+    thread.start(_thread_func, this);
+
+    if (p_capture_engine_errors == true && error_handler_added == false)
+    {
+        error_handler.errfunc = _error_handler;
+        error_handler.userdata = this;
+        add_error_handler(&error_handler);
+        error_handler_added = true;
+    }
+}
+
+void CrashpadErrorReporter::stop()
+{
+    if (error_handler_added == true)
+    {
+        remove_error_handler(&error_handler);
+        error_handler_added = false;
+    }
+    if (thread.is_started())
+    {
+        // The worker sends what is left before it exits
+        exit_requested.set();
+        thread.wait_to_finish();
+    }
+}
+
+void CrashpadErrorReporter::request_stop()
+{
+    // Errors printed while crashing must not reach _add(), which allocates and locks
+    if (error_handler_added == true)
+    {
+        remove_error_handler(&error_handler);
+        error_handler_added = false;
+    }
+    cancelled.set();
+    exit_requested.set();
+    uploader.cancel();
+}
+
+void CrashpadErrorReporter::report(const String &p_message, const Dictionary &p_attributes)
+{
+    _add(p_message, "", "script", p_attributes, 1);
+}
+
+void CrashpadErrorReporter::_error_handler(void *p_userdata, const char *p_function, const char *p_file, int p_line, const char *p_error, const char *p_error_expression, ErrorHandlerType p_type)
+{
+    if (p_type == ERR_HANDLER_WARNING)
+    {
+        return;
+    }
+    CrashpadErrorReporter *self = (CrashpadErrorReporter *)p_userdata;
+    String message = String::utf8(p_error_expression != nullptr && p_error_expression[0] != '\0' ? p_error_expression : p_error);
+    String source = String::utf8(p_file) + ":" + itos(p_line) + " @ " + String::utf8(p_function);
+    self->_add(message, source, p_type == ERR_HANDLER_SCRIPT ? "script" : (p_type == ERR_HANDLER_SHADER ? "shader" : "engine"), Dictionary(), 1);
+}
+
+void CrashpadErrorReporter::_add(const String &p_message, const String &p_source, const String &p_type, const Dictionary &p_attributes, uint32_t p_count)
+{
+    String key = p_source.empty() ? p_message : p_source + "\n" + p_message;
+    uint64_t now = OS::get_singleton()->get_unix_time();
+
+    mutex.lock();
+    ErrorEntry *entry = errors.getptr(key);
+    if (entry != nullptr)
+    {
+        entry->count += p_count;
+        entry->last_time = now;
+    }
+    else if ((int)errors.size() >= CRASHPAD_ERROR_REPORTER_MAX_ERRORS)
+    {
+        dropped_count += p_count;
+    }
+    else
+    {
+        ErrorEntry new_entry;
+        new_entry.message = p_message;
+        new_entry.source = p_source;
+        new_entry.type = p_type;
+        new_entry.attributes = p_attributes;
+        new_entry.count = p_count;
+        new_entry.first_time = now;
+        new_entry.last_time = now;
+        errors.set(key, new_entry);
+
+        if (pending_since_msec == 0)
+        {
+            pending_since_msec = OS::get_singleton()->get_ticks_msec();
+        }
+        if ((int)errors.size() >= max_batch_size)
+        {
+            flush_requested.set();
+        }
+    }
+    mutex.unlock();
+}
+
+Error CrashpadErrorReporter::_send(const ErrorEntry &p_entry)
+{
+    Dictionary report_attributes = attributes.duplicate();
+    Dictionary live_annotations = CrashpadAnnotations::get_all();
+    for (int i = 0; i < live_annotations.size(); i++)
+    {
+        report_attributes[live_annotations.get_key_at_index(i)] = live_annotations.get_value_at_index(i);
+    }
+    for (int i = 0; i < p_entry.attributes.size(); i++)
+    {
+        report_attributes[p_entry.attributes.get_key_at_index(i)] = p_entry.attributes.get_value_at_index(i);
+    }
+    report_attributes["error.message"] = p_entry.message;
+    report_attributes["error.type"] = p_entry.type;
+    report_attributes["godot_error_count"] = p_entry.count;
+    report_attributes["godot_error_first_time"] = p_entry.first_time;
+    report_attributes["godot_error_last_time"] = p_entry.last_time;
+
+    Array stack;
+    if (p_entry.source.empty() == false)
+    {
+        Dictionary frame;
+        frame["funcName"] = p_entry.source;
+        stack.push_back(frame);
+    }
+    Dictionary thread_info;
+    thread_info["name"] = "main";
+    thread_info["stack"] = stack;
+    Dictionary threads;
+    threads["main"] = thread_info;
+
+    // Backtrace wants a UUID for every report
+    String hash = (p_entry.source + p_entry.message + itos(p_entry.last_time) + itos(OS::get_singleton()->get_ticks_usec())).md5_text();
+    String uuid = hash.substr(0, 8) + "-" + hash.substr(8, 4) + "-" + hash.substr(12, 4) + "-" + hash.substr(16, 4) + "-" + hash.substr(20, 12);
+
+    Dictionary report;
+    report["uuid"] = uuid;
+    report["timestamp"] = p_entry.last_time;
+    report["lang"] = p_entry.type == "engine" ? "c++" : "gdscript";
+    report["langVersion"] = "";
+    report["agent"] = "godot-crashpad";
+    report["agentVersion"] = "1.0";
+    report["mainThread"] = "main";
+    report["threads"] = threads;
+    report["attributes"] = report_attributes;
+
+    CrashpadMemoryBody body;
+    body.set_data(JSON::print(report).utf8(), "application/json");
+    int response_code = 0;
+    Error error = uploader.post(report_url, &body, Vector<String>(), response_code);
+    if (error != OK)
+    {
+        return error;
+    }
+    return response_code >= 200 && response_code < 300 ? OK : ERR_QUERY_FAILED;
+}
+
+void CrashpadErrorReporter::_flush(uint64_t p_deadline_msec)
+{
+    HashMap<String, ErrorEntry> batch;
+    uint32_t dropped = 0;
+    mutex.lock();
+    batch = errors;
+    errors.clear();
+    dropped = dropped_count;
+    dropped_count = 0;
+    pending_since_msec = 0;
+    flush_requested.clear();
+    mutex.unlock();
+
+    if (dropped > 0)
+    {
+        Dictionary dropped_attributes;
+        _add("Errors not reported because too many different errors happened at once", "", "engine", dropped_attributes, dropped);
+    }
+
+    // Printing through the error macros here would report our own errors, so only print_line is used
+    const String *key = nullptr;
+    bool failed = false;
+    while ((key = batch.next(key)) != nullptr)
+    {
+        const ErrorEntry &entry = batch.get(*key);
+        bool in_time = true;
+        if (p_deadline_msec != 0)
+        {
+            // Each request only gets what is left of the time
+            uint64_t now = OS::get_singleton()->get_ticks_msec();
+            in_time = now < p_deadline_msec;
+            if (in_time == true)
+            {
+                uploader.connect_timeout_msec = MIN(connect_timeout_msec, (int)(p_deadline_msec - now));
+                uploader.total_timeout_msec = MIN(total_timeout_msec, (int)(p_deadline_msec - now));
+            }
+        }
+        if (failed == false && in_time == true && cancelled.is_set() == false && _send(entry) == OK)
+        {
+            continue;
+        }
+        if (failed == false)
+        {
+            print_line("Crashpad Warning: Could not send error reports, they will be retried later.");
+            failed = true;
+        }
+        // Not sent: merge it back in, with the errors that came in meanwhile
+        mutex.lock();
+        ErrorEntry *pending = errors.getptr(*key);
+        if (pending != nullptr)
+        {
+            pending->count += entry.count;
+            pending->first_time = entry.first_time;
+        }
+        else if ((int)errors.size() < CRASHPAD_ERROR_REPORTER_MAX_ERRORS)
+        {
+            errors.set(*key, entry);
+        }
+        if (pending_since_msec == 0)
+        {
+            pending_since_msec = OS::get_singleton()->get_ticks_msec();
+        }
+        mutex.unlock();
+    }
+    uploader.close();
+}
+
+void CrashpadErrorReporter::_thread_func(void *p_userdata)
+{
+    ((CrashpadErrorReporter *)p_userdata)->_run();
+}
+
+void CrashpadErrorReporter::_run()
+{
+    while (exit_requested.is_set() == false)
+    {
+        OS::get_singleton()->delay_usec(CRASHPAD_ERROR_REPORTER_POLL_USEC);
+
+        mutex.lock();
+        uint64_t pending_since = pending_since_msec;
+        mutex.unlock();
+        bool interval_passed = pending_since != 0 && OS::get_singleton()->get_ticks_msec() - pending_since >= (uint64_t)flush_interval_sec * 1000;
+        if (flush_requested.is_set() || interval_passed)
+        {
+            _flush();
+        }
+    }
+
+    // One last, short try on the way out (skipped if we were cancelled)
+    if (cancelled.is_set() == false)
+    {
+        _flush(OS::get_singleton()->get_ticks_msec() + CRASHPAD_ERROR_REPORTER_EXIT_FLUSH_MSEC);
+    }
+}
+
+CrashpadErrorReporter::CrashpadErrorReporter()
+{
+    error_handler.errfunc = nullptr;
+    error_handler.userdata = nullptr;
+    error_handler.next = nullptr;
+}
+
+CrashpadErrorReporter::~CrashpadErrorReporter()
+{
+    stop();
+}
@@ -0,0 +1,74 @@
+/* crashpad_error_reporter.h */
+
+#ifndef CRASHPAD_ERROR_REPORTER_H
+#define CRASHPAD_ERROR_REPORTER_H
+
+#include "core/dictionary.h"
+#include "core/error_macros.h"
+#include "core/hash_map.h"
+#include "core/os/mutex.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+#include "crashpad_uploader.h"
+
+// Reports non-fatal errors, from scripts (report_error) and optionally from Godot's own error printing.
+// Identical errors are merged in memory with a count, so reporting one costs a lock and a hash lookup.
+// A worker thread sends what was collected as Backtrace JSON reports (one per distinct error, over one
+// kept-alive connection) when enough distinct errors piled up or the flush interval passed.
+class CrashpadErrorReporter {
+    struct ErrorEntry {
+        String message;
+        String source;
+        String type;
+        Dictionary attributes;
+        uint32_t count = 0;
+        uint64_t first_time = 0;
+        uint64_t last_time = 0;
+    };
+
+    HashMap<String, ErrorEntry> errors;
+    uint64_t pending_since_msec = 0;
+    uint32_t dropped_count = 0;
+    Mutex mutex;
+
+    Thread thread;
+    SafeFlag exit_requested;
+    SafeFlag cancelled;
+    SafeFlag flush_requested;
+    CrashpadUploader uploader;
+    int connect_timeout_msec = 5000;
+    int total_timeout_msec = 30000;
+    String report_url;
+    Dictionary attributes;
+
+    ErrorHandlerList error_handler;
+    bool error_handler_added = false;
+
+    void _add(const String &p_message, const String &p_source, const String &p_type, const Dictionary &p_attributes, uint32_t p_count);
+    Error _send(const ErrorEntry &p_entry);
+    void _flush(uint64_t p_deadline_msec = 0);
+    void _run();
+    static void _thread_func(void *p_userdata);
+    static void _error_handler(void *p_userdata, const char *p_function, const char *p_file, int p_line, const char *p_error, const char *p_error_expression, ErrorHandlerType p_type);
+
+public:
+    int flush_interval_sec = 60;
+    int max_batch_size = 50;
+
+    void set_timeouts(int p_connect_timeout_msec, int p_total_timeout_msec);
+
+    void start(const String &p_report_url, const Dictionary &p_attributes, bool p_capture_engine_errors);
+    // Sends what is left and waits for the worker thread. The last flush gives up after a few seconds,
+    // so quitting the game never waits on a slow server for long.
+    void stop();
+    // Stops capturing engine errors and only asks the worker to stop, for use where joining a thread
+    // is not safe (e.g. while crashing).
+    void request_stop();
+
+    void report(const String &p_message, const Dictionary &p_attributes);
+
+    CrashpadErrorReporter();
+    ~CrashpadErrorReporter();
+};
+
+#endif // CRASHPAD_ERROR_REPORTER_H
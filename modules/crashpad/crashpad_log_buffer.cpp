@@ -0,0 +1,179 @@
+/* crashpad_log_buffer.cpp */
+
+#include "crashpad_log_buffer.h"
+#include "core/os/file_access.h"
+#include "core/os/memory.h"
+
+#include <stdio.h>
+
+// Longer log lines are cut, so formatting never needs the heap
+#define CRASHPAD_LOG_BUFFER_MAX_LINE 1024
+#define CRASHPAD_LOG_FILE_READ_BLOCK 4096
+
+
+void CrashpadLogBuffer::logv(const char *p_format, va_list p_list, bool p_err)
+{
+    if (should_log(p_err) == false)
+    {
+        return;
+    }
+
+    char line[CRASHPAD_LOG_BUFFER_MAX_LINE];
+    int length = vsnprintf(line, CRASHPAD_LOG_BUFFER_MAX_LINE, p_format, p_list);
+    if (length <= 0)
+    {
+        return;
+    }
+    length = MIN(length, CRASHPAD_LOG_BUFFER_MAX_LINE - 1);
+
+    mutex.lock();
+    _write(line, length);
+    mutex.unlock();
+}
+
+void CrashpadLogBuffer::_write(const char *p_data, int p_size)
+{
+    // Only the end of a message bigger than the whole buffer would survive anyway
+    if (p_size > buffer_size)
+    {
+        p_data += p_size - buffer_size;
+        p_size = buffer_size;
+    }
+
+    int position = written % buffer_size;
+    int first_part = MIN(p_size, buffer_size - position);
+    memcpy(buffer + position, p_data, first_part);
+    memcpy(buffer, p_data + first_part, p_size - first_part);
+    written += p_size;
+}
+
+int CrashpadLogBuffer::copy_tail(char *r_buffer, int p_max_bytes, int p_max_lines) const
+{
+    uint64_t total = written;
+    int available = (int)MIN(total, (uint64_t)buffer_size);
+    int count = MIN(available, p_max_bytes);
+    if (count <= 0)
+    {
+        return 0;
+    }
+
+    int start = (total - count) % buffer_size;
+    int first_part = MIN(count, buffer_size - start);
+    memcpy(r_buffer, buffer + start, first_part);
+    memcpy(r_buffer + first_part, buffer, count - first_part);
+
+    // Drop the partial first line, unless the copy already starts at the beginning of the log
+    int skip = 0;
+    if (total > (uint64_t)count)
+    {
+        while (skip < count && r_buffer[skip] != '\n')
+        {
+            skip++;
+        }
+        skip = MIN(skip + 1, count);
+    }
+
+    // Keep only the last lines
+    if (p_max_lines > 0)
+    {
+        int lines = 0;
+        // A newline at the very end closes the last line, it does not start a new one
+        for (int i = count - 2; i >= skip; i--)
+        {
+            if (r_buffer[i] == '\n')
+            {
+                lines++;
+                if (lines >= p_max_lines)
+                {
+                    skip = i + 1;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (skip > 0)
+    {
+        memmove(r_buffer, r_buffer + skip, count - skip);
+    }
+    return count - skip;
+}
+
+Error CrashpadLogBuffer::find_file_tail(const String &p_file_path, uint64_t p_max_bytes, int p_max_lines, uint64_t &r_offset, uint64_t &r_length)
+{
+    FileAccess *file = FileAccess::open(p_file_path, FileAccess::READ);
+    if (file == nullptr)
+    {
+        return ERR_FILE_CANT_OPEN;
+    }
+
+    uint64_t file_length = file->get_len();
+    uint64_t limit = file_length > p_max_bytes ? file_length - p_max_bytes : 0;
+    uint64_t start = limit;
+
+    // Walk backwards block by block, counting newlines, until enough lines are found
+    if (p_max_lines > 0 && file_length > 0)
+    {
+        uint8_t block[CRASHPAD_LOG_FILE_READ_BLOCK];
+        int lines = 0;
+        // Skip a newline at the very end, it closes the last line
+        uint64_t block_end = file_length - 1;
+        bool found = false;
+        while (block_end > limit && found == false)
+        {
+            uint64_t block_start = block_end > limit + CRASHPAD_LOG_FILE_READ_BLOCK ? block_end - CRASHPAD_LOG_FILE_READ_BLOCK : limit;
+            int block_length = block_end - block_start;
+            file->seek(block_start);
+            if (file->get_buffer(block, block_length) != block_length)
+            {
+                break;
+            }
+            for (int i = block_length - 1; i >= 0; i--)
+            {
+                if (block[i] == '\n')
+                {
+                    lines++;
+                    if (lines >= p_max_lines)
+                    {
+                        start = block_start + i + 1;
+                        found = true;
+                        break;
+                    }
+                }
+            }
+            block_end = block_start;
+        }
+    }
+
+    // Do not start in the middle of a line if the byte limit cut one
+    if (start == limit && start > 0)
+    {
+        file->seek(start - 1);
+        if (file->get_8() != '\n')
+        {
+            while (start < file_length && file->get_8() != '\n')
+            {
+                start++;
+            }
+            start = MIN(start + 1, file_length);
+        }
+    }
+
+    file->close();
+    memdelete(file);
+
+    r_offset = start;
+    r_length = file_length - start;
+    return OK;
+}
+
+CrashpadLogBuffer::CrashpadLogBuffer(int p_buffer_size)
+{
+    buffer_size = MAX(p_buffer_size, CRASHPAD_LOG_BUFFER_MAX_LINE);
+    buffer = (char *)memalloc(buffer_size);
+}
+
+CrashpadLogBuffer::~CrashpadLogBuffer()
+{
+    memfree(buffer);
+}
@@ -0,0 +1,38 @@
+/* crashpad_log_buffer.h */
+
+#ifndef CRASHPAD_LOG_BUFFER_H
+#define CRASHPAD_LOG_BUFFER_H
+
+#include "core/io/logger.h"
+#include "core/os/mutex.h"
+#include "core/ustring.h"
+
+// A Godot logger that keeps the most recent output in a fixed size ring buffer.
+// Nothing is allocated after construction, so the tail of the log can be copied
+// out at crash time, even from a signal or exception handler.
+class CrashpadLogBuffer : public Logger {
+    char *buffer = nullptr;
+    int buffer_size = 0;
+    // Total number of bytes ever written. The write position is this modulo the buffer size.
+    uint64_t written = 0;
+    Mutex mutex;
+
+    void _write(const char *p_data, int p_size);
+
+public:
+    virtual void logv(const char *p_format, va_list p_list, bool p_err) _PRINTF_FORMAT_ATTRIBUTE_2_0;
+
+    // Copies the last p_max_bytes bytes (and at most p_max_lines lines, if above 0) of the log
+    // into r_buffer, starting at the beginning of a line. Returns the number of bytes copied.
+    // Does not lock, so it can be called while crashing. Lines written at the same time may be torn.
+    int copy_tail(char *r_buffer, int p_max_bytes, int p_max_lines) const;
+
+    // Finds the byte range of the last p_max_bytes bytes / p_max_lines lines of a log file,
+    // reading backwards from the end so only the tail of the file is touched.
+    static Error find_file_tail(const String &p_file_path, uint64_t p_max_bytes, int p_max_lines, uint64_t &r_offset, uint64_t &r_length);
+
+    CrashpadLogBuffer(int p_buffer_size);
+    ~CrashpadLogBuffer();
+};
+
+#endif // CRASHPAD_LOG_BUFFER_H
@@ -0,0 +1,135 @@
+/* crashpad_memory_ranges.cpp */
+
+#include "crashpad_memory_ranges.h"
+#include "core/os/memory.h"
+#include "crashpad_annotations.h"
+#include "crashpad_platform.h"
+
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+#include "crashpad/client/crashpad_info.h"
+#include "crashpad/client/simple_address_range_bag.h"
+
+static crashpad::SimpleAddressRangeBag crashpad_extra_memory_ranges;
+#endif
+
+// Heap memory captured from the stacks with the standard and full profiles
+#define CRASHPAD_STANDARD_INDIRECT_MEMORY_LIMIT (1024 * 1024)
+#define CRASHPAD_FULL_INDIRECT_MEMORY_LIMIT 0xFFFFFFFF
+
+Mutex CrashpadMemoryRanges::mutex;
+bool CrashpadMemoryRanges::registered = false;
+Map<String, CrashpadMemoryRanges::Block> CrashpadMemoryRanges::blocks;
+
+
+void CrashpadMemoryRanges::_register()
+{
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+    if (registered == false)
+    {
+        crashpad::CrashpadInfo::GetCrashpadInfo()->set_extra_memory_ranges(&crashpad_extra_memory_ranges);
+        registered = true;
+    }
+#endif
+}
+
+void CrashpadMemoryRanges::set_dump_profile(DumpProfile p_profile)
+{
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+    crashpad::CrashpadInfo *info = crashpad::CrashpadInfo::GetCrashpadInfo();
+    if (p_profile == DUMP_PROFILE_FULL)
+    {
+        info->set_gather_indirectly_referenced_memory(crashpad::TriState::kEnabled, CRASHPAD_FULL_INDIRECT_MEMORY_LIMIT);
+    }
+    else if (p_profile == DUMP_PROFILE_STANDARD)
+    {
+        info->set_gather_indirectly_referenced_memory(crashpad::TriState::kEnabled, CRASHPAD_STANDARD_INDIRECT_MEMORY_LIMIT);
+    }
+    else
+    {
+        info->set_gather_indirectly_referenced_memory(crashpad::TriState::kDisabled, 0);
+    }
+#endif
+}
+
+bool CrashpadMemoryRanges::add_range(const void *p_address, size_t p_size)
+{
+    bool added = false;
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+    mutex.lock();
+    _register();
+    added = crashpad_extra_memory_ranges.Insert(p_address, p_size);
+    mutex.unlock();
+#endif
+    return added;
+}
+
+void CrashpadMemoryRanges::remove_range(const void *p_address, size_t p_size)
+{
+#if defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED
+    mutex.lock();
+    crashpad_extra_memory_ranges.Remove(p_address, p_size);
+    mutex.unlock();
+#endif
+}
+
+bool CrashpadMemoryRanges::set_block(const String &p_key, const PoolVector<uint8_t> &p_data)
+{
+#if !(defined WINDOWS_ENABLED || defined OSX_ENABLED || defined CRASHPAD_LINUX_ENABLED)
+    return false;
+#endif
+    ERR_FAIL_COND_V(p_data.size() == 0, false);
+    remove_block(p_key);
+
+    Block block;
+    block.size = p_data.size();
+    block.data = (uint8_t *)memalloc(block.size);
+    PoolVector<uint8_t>::Read read = p_data.read();
+    memcpy(block.data, read.ptr(), block.size);
+
+    if (add_range(block.data, block.size) == false)
+    {
+        memfree(block.data);
+        ERR_PRINT("Could not add the memory block '" + p_key + "' to crash dumps, there are too many memory ranges.");
+        return false;
+    }
+
+    mutex.lock();
+    blocks.insert(p_key, block);
+    mutex.unlock();
+    CrashpadAnnotations::set("memory_block:" + p_key, String::num_uint64((uint64_t)block.data, 16) + ":" + itos(block.size));
+    return true;
+}
+
+void CrashpadMemoryRanges::remove_block(const String &p_key)
+{
+    mutex.lock();
+    Map<String, Block>::Element *E = blocks.find(p_key);
+    if (E == nullptr)
+    {
+        mutex.unlock();
+        return;
+    }
+    Block block = E->get();
+    blocks.erase(E);
+    mutex.unlock();
+
+    remove_range(block.data, block.size);
+    CrashpadAnnotations::remove("memory_block:" + p_key);
+    memfree(block.data);
+}
+
+void CrashpadMemoryRanges::clear_blocks()
+{
+    mutex.lock();
+    Vector<String> keys;
+    for (Map<String, Block>::Element *E = blocks.front(); E; E = E->next())
+    {
+        keys.push_back(E->key());
+    }
+    mutex.unlock();
+
+    for (int i = 0; i < keys.size(); i++)
+    {
+        remove_block(keys[i]);
+    }
+}
@@ -0,0 +1,57 @@
+/* crashpad_memory_ranges.h */
+
+#ifndef CRASHPAD_MEMORY_RANGES_H
+#define CRASHPAD_MEMORY_RANGES_H
+
+#include "core/map.h"
+#include "core/os/mutex.h"
+#include "core/pool_vector.h"
+#include "core/ustring.h"
+
+// Controls how much memory the handler puts in a dump.
+// The dump profile picks whether heap memory referenced from the stacks is captured, and specific
+// memory ranges (or small blocks of data copied from scripts) can be added to every dump on top of it.
+// Everything is registered with CrashpadInfo, which the handler reads out of the process when it takes a dump.
+class CrashpadMemoryRanges {
+public:
+    enum DumpProfile {
+        // Threads, stacks and modules only
+        DUMP_PROFILE_MINIMAL,
+        // Also the heap memory pointed to from the stacks, up to a small limit
+        DUMP_PROFILE_STANDARD,
+        // Also the heap memory pointed to from the stacks, without a practical limit
+        DUMP_PROFILE_FULL,
+    };
+
+    enum {
+        // The size of Crashpad's SimpleAddressRangeBag
+        MAX_RANGES = 64,
+    };
+
+private:
+    struct Block {
+        uint8_t *data = nullptr;
+        size_t size = 0;
+    };
+
+    static Mutex mutex;
+    static bool registered;
+    static Map<String, Block> blocks;
+
+    static void _register();
+
+public:
+    static void set_dump_profile(DumpProfile p_profile);
+
+    // The memory has to stay valid until it is removed again
+    static bool add_range(const void *p_address, size_t p_size);
+    static void remove_range(const void *p_address, size_t p_size);
+
+    // Copies the data into a buffer that is included in every dump. The block is also listed in the
+    // "memory_block:<key>" annotation as "<address>:<size>", so it can be found in the dump again.
+    static bool set_block(const String &p_key, const PoolVector<uint8_t> &p_data);
+    static void remove_block(const String &p_key);
+    static void clear_blocks();
+};
+
+#endif // CRASHPAD_MEMORY_RANGES_H
@@ -0,0 +1,12 @@
+/* crashpad_platform.h */
+
+#ifndef CRASHPAD_PLATFORM_H
+#define CRASHPAD_PLATFORM_H
+
+// Desktop (X11) and headless server builds on Linux share one capture and upload path:
+// the handler does not upload there, so the module waits for the dump and uploads it itself.
+#if defined X11_ENABLED || defined LINUXBSD_ENABLED || (defined SERVER_ENABLED && defined __linux__)
+#define CRASHPAD_LINUX_ENABLED
+#endif
+
+#endif // CRASHPAD_PLATFORM_H
@@ -0,0 +1,191 @@
+/* crashpad_rate_limiter.cpp */
+
+#include "crashpad_rate_limiter.h"
+#include "crashpad_state_file.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+
+#define CRASHPAD_RATE_LIMITER_MAGIC 0x4c524347 // "GCRL"
+#define CRASHPAD_RATE_LIMITER_VERSION 1
+
+#define CRASHPAD_RATE_LIMITER_HOUR_SEC 3600
+#define CRASHPAD_RATE_LIMITER_DAY_SEC 86400
+
+
+Error CrashpadRateLimiter::open(const String &p_database_path)
+{
+    database_path = p_database_path;
+    state_path = database_path.plus_file("godot_rate_limit.dat");
+    upload_times.clear();
+    signature_upload_times.clear();
+    dirty = false;
+
+    // Without a history, the limits simply start counting from now
+    if (_load() != OK)
+    {
+        upload_times.clear();
+        signature_upload_times.clear();
+    }
+    opened = true;
+    return OK;
+}
+
+Error CrashpadRateLimiter::_load()
+{
+    Error error = OK;
+    FileAccess *file = CrashpadStateFile::open_for_read(state_path, CRASHPAD_RATE_LIMITER_MAGIC, CRASHPAD_RATE_LIMITER_VERSION, error);
+    if (file == nullptr)
+    {
+        return error;
+    }
+
+    uint32_t upload_count = file->get_32();
+    for (uint32_t i = 0; i < upload_count && file->eof_reached() == false; i++)
+    {
+        upload_times.push_back(file->get_64());
+    }
+    uint32_t signature_count = file->get_32();
+    for (uint32_t i = 0; i < signature_count && file->eof_reached() == false; i++)
+    {
+        String signature = file->get_pascal_string();
+        Vector<uint64_t> times;
+        uint32_t time_count = file->get_32();
+        for (uint32_t j = 0; j < time_count && file->eof_reached() == false; j++)
+        {
+            times.push_back(file->get_64());
+        }
+        signature_upload_times.insert(signature, times);
+    }
+
+    bool broken = file->eof_reached();
+    file->close();
+    memdelete(file);
+    return broken ? ERR_FILE_CORRUPT : OK;
+}
+
+void CrashpadRateLimiter::_prune(uint64_t p_now)
+{
+    // Times in the future mean the clock was changed, so they are dropped too
+    for (int i = upload_times.size() - 1; i >= 0; i--)
+    {
+        if (upload_times[i] > p_now || p_now - upload_times[i] >= CRASHPAD_RATE_LIMITER_HOUR_SEC)
+        {
+            upload_times.remove(i);
+            dirty = true;
+        }
+    }
+
+    Vector<String> empty_signatures;
+    for (Map<String, Vector<uint64_t> >::Element *E = signature_upload_times.front(); E; E = E->next())
+    {
+        Vector<uint64_t> &times = E->get();
+        for (int i = times.size() - 1; i >= 0; i--)
+        {
+            if (times[i] > p_now || p_now - times[i] >= CRASHPAD_RATE_LIMITER_DAY_SEC)
+            {
+                times.remove(i);
+                dirty = true;
+            }
+        }
+        if (times.empty() == true)
+        {
+            empty_signatures.push_back(E->key());
+        }
+    }
+    for (int i = 0; i < empty_signatures.size(); i++)
+    {
+        signature_upload_times.erase(empty_signatures[i]);
+    }
+}
+
+Error CrashpadRateLimiter::save()
+{
+    ERR_FAIL_COND_V(opened == false, ERR_UNCONFIGURED);
+    _prune(OS::get_singleton()->get_unix_time());
+    if (dirty == false)
+    {
+        return OK;
+    }
+
+    FileAccess *file = CrashpadStateFile::begin_save(state_path, CRASHPAD_RATE_LIMITER_MAGIC, CRASHPAD_RATE_LIMITER_VERSION);
+    if (file == nullptr)
+    {
+        return ERR_FILE_CANT_WRITE;
+    }
+    file->store_32(upload_times.size());
+    for (int i = 0; i < upload_times.size(); i++)
+    {
+        file->store_64(upload_times[i]);
+    }
+    file->store_32(signature_upload_times.size());
+    for (Map<String, Vector<uint64_t> >::Element *E = signature_upload_times.front(); E; E = E->next())
+    {
+        file->store_pascal_string(E->key());
+        file->store_32(E->get().size());
+        for (int i = 0; i < E->get().size(); i++)
+        {
+            file->store_64(E->get()[i]);
+        }
+    }
+    Error error = CrashpadStateFile::end_save(file, state_path);
+    if (error == OK)
+    {
+        dirty = false;
+    }
+    return error;
+}
+
+bool CrashpadRateLimiter::can_upload(const String &p_signature)
+{
+    ERR_FAIL_COND_V(opened == false, true);
+    _prune(OS::get_singleton()->get_unix_time());
+
+    if (max_uploads_per_hour > 0 && upload_times.size() >= max_uploads_per_hour)
+    {
+        return false;
+    }
+    if (max_uploads_per_signature_per_day > 0 && p_signature.empty() == false)
+    {
+        const Map<String, Vector<uint64_t> >::Element *E = signature_upload_times.find(p_signature);
+        if (E != nullptr && E->get().size() >= max_uploads_per_signature_per_day)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CrashpadRateLimiter::record_upload(const String &p_signature)
+{
+    ERR_FAIL_COND(opened == false);
+    uint64_t now = OS::get_singleton()->get_unix_time();
+    upload_times.push_back(now);
+    if (p_signature.empty() == false)
+    {
+        if (signature_upload_times.has(p_signature) == false)
+        {
+            signature_upload_times.insert(p_signature, Vector<uint64_t>());
+        }
+        signature_upload_times[p_signature].push_back(now);
+    }
+    dirty = true;
+}
+
+bool CrashpadRateLimiter::is_sampled(const String &p_key, float p_sampling_percent)
+{
+    if (p_sampling_percent >= 100.0f)
+    {
+        return true;
+    }
+    if (p_sampling_percent <= 0.0f)
+    {
+        return false;
+    }
+    // Spread the keys over 0-9999, i.e. steps of 0.01%
+    uint32_t bucket = p_key.hash() % 10000;
+    return bucket < (uint32_t)(p_sampling_percent * 100.0f);
+}
+
+CrashpadRateLimiter::CrashpadRateLimiter()
+{
+}
@@ -0,0 +1,50 @@
+/* crashpad_rate_limiter.h */
+
+#ifndef CRASHPAD_RATE_LIMITER_H
+#define CRASHPAD_RATE_LIMITER_H
+
+#include "core/map.h"
+#include "core/os/mutex.h"
+#include "core/ustring.h"
+#include "core/vector.h"
+
+// Keeps a bad release from flooding the crash server.
+// Remembers when this install uploaded reports, overall and per crash signature, so uploads can be
+// capped per hour and per signature per day. The history is stored next to the Crashpad database.
+// Like the report index, callers on other threads have to hold lock() while using it.
+class CrashpadRateLimiter {
+    String database_path;
+    String state_path;
+    Vector<uint64_t> upload_times;
+    Map<String, Vector<uint64_t> > signature_upload_times;
+    bool opened = false;
+    bool dirty = false;
+    Mutex mutex;
+
+    Error _load();
+    void _prune(uint64_t p_now);
+
+public:
+    // 0 means no limit
+    int max_uploads_per_hour = 0;
+    int max_uploads_per_signature_per_day = 0;
+
+    void lock() { mutex.lock(); }
+    Error try_lock() { return mutex.try_lock(); }
+    void unlock() { mutex.unlock(); }
+
+    Error open(const String &p_database_path);
+    bool is_open() const { return opened; }
+    Error save();
+
+    // The signature can be empty if it is not known, then only the hourly limit applies
+    bool can_upload(const String &p_signature);
+    void record_upload(const String &p_signature);
+
+    // Decides from the key alone, so retrying the same report always gets the same answer
+    static bool is_sampled(const String &p_key, float p_sampling_percent);
+
+    CrashpadRateLimiter();
+};
+
+#endif // CRASHPAD_RATE_LIMITER_H
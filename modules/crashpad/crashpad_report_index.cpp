@@ -0,0 +1,306 @@
+/* crashpad_report_index.cpp */
+
+#include "crashpad_report_index.h"
+#include "crashpad_state_file.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+
+#define CRASHPAD_REPORT_INDEX_MAGIC 0x49524347 // "GCRI"
+#define CRASHPAD_REPORT_INDEX_VERSION 1
+
+
+Error CrashpadReportIndex::open(const String &p_database_path)
+{
+    database_path = p_database_path;
+    index_path = database_path.plus_file("godot_report_index.dat");
+    reports.clear();
+    pending_modified_time = 0;
+    dirty = false;
+
+    // A missing or broken index is not an error, it just gets rebuilt from the "pending/" folder
+    if (_load() != OK)
+    {
+        reports.clear();
+        pending_modified_time = 0;
+        dirty = true;
+    }
+    opened = true;
+    return OK;
+}
+
+Error CrashpadReportIndex::_load()
+{
+    Error error = OK;
+    FileAccess *file = CrashpadStateFile::open_for_read(index_path, CRASHPAD_REPORT_INDEX_MAGIC, CRASHPAD_REPORT_INDEX_VERSION, error);
+    if (file == nullptr)
+    {
+        return error;
+    }
+
+    pending_modified_time = file->get_64();
+    uint32_t report_count = file->get_32();
+    for (uint32_t i = 0; i < report_count; i++)
+    {
+        Report report;
+        report.id = file->get_pascal_string();
+        report.path = file->get_pascal_string();
+        report.size = file->get_64();
+        report.state = (ReportState)file->get_8();
+        report.attempts = file->get_32();
+        if (file->eof_reached())
+        {
+            file->close();
+            memdelete(file);
+            return ERR_FILE_CORRUPT;
+        }
+        reports.insert(report.id, report);
+    }
+
+    file->close();
+    memdelete(file);
+    return OK;
+}
+
+Error CrashpadReportIndex::save()
+{
+    ERR_FAIL_COND_V(opened == false, ERR_UNCONFIGURED);
+    if (dirty == false)
+    {
+        return OK;
+    }
+
+    FileAccess *file = CrashpadStateFile::begin_save(index_path, CRASHPAD_REPORT_INDEX_MAGIC, CRASHPAD_REPORT_INDEX_VERSION);
+    if (file == nullptr)
+    {
+        return ERR_FILE_CANT_WRITE;
+    }
+    file->store_64(pending_modified_time);
+    file->store_32(reports.size());
+    for (Map<String, Report>::Element *E = reports.front(); E; E = E->next())
+    {
+        const Report &report = E->get();
+        file->store_pascal_string(report.id);
+        file->store_pascal_string(report.path);
+        file->store_64(report.size);
+        file->store_8(report.state);
+        file->store_32(report.attempts);
+    }
+    Error error = CrashpadStateFile::end_save(file, index_path);
+    if (error == OK)
+    {
+        dirty = false;
+    }
+    return error;
+}
+
+void CrashpadReportIndex::reconcile(bool p_force)
+{
+    ERR_FAIL_COND(opened == false);
+
+    String pending_path = database_path.plus_file("pending");
+    uint64_t modified_time = FileAccess::get_modified_time(pending_path);
+    if (p_force == false && modified_time != 0 && modified_time == pending_modified_time)
+    {
+        return;
+    }
+
+    DirAccess *dir = DirAccess::open(pending_path);
+    if (dir == nullptr)
+    {
+        // No "pending/" folder means the handler has never written a report
+        if (reports.empty() == false)
+        {
+            reports.clear();
+            dirty = true;
+        }
+        return;
+    }
+
+    Map<String, bool> seen_ids;
+    dir->list_dir_begin(true, false);
+    String file_name = dir->get_next();
+    while (file_name != "")
+    {
+        // The handler moves the ".dmp" in last and removes the lock after that, so only those are complete
+        if (dir->current_is_dir() == false && file_name.ends_with(".dmp"))
+        {
+            String id = file_name.get_basename();
+            if (FileAccess::exists(pending_path.plus_file(id + ".lock")) == false)
+            {
+                seen_ids.insert(id, true);
+                if (reports.has(id) == false)
+                {
+                    _add_report(pending_path.plus_file(file_name));
+                }
+            }
+        }
+        file_name = dir->get_next();
+    }
+    dir->list_dir_end();
+    memdelete(dir);
+
+    Vector<String> missing_ids;
+    for (Map<String, Report>::Element *E = reports.front(); E; E = E->next())
+    {
+        if (seen_ids.has(E->key()) == false)
+        {
+            missing_ids.push_back(E->key());
+        }
+    }
+    for (int i = 0; i < missing_ids.size(); i++)
+    {
+        reports.erase(missing_ids[i]);
+    }
+
+    // A report written later in the same second would not change the time, so list again next time
+    bool settled = modified_time != 0 && modified_time < (uint64_t)OS::get_singleton()->get_unix_time();
+    pending_modified_time = settled ? modified_time : 0;
+    dirty = true;
+}
+
+void CrashpadReportIndex::_add_report(const String &p_dump_path)
+{
+    Report report;
+    report.id = get_report_id_from_path(p_dump_path);
+    report.path = p_dump_path;
+
+    FileAccess *file = FileAccess::open(p_dump_path, FileAccess::READ);
+    if (file != nullptr)
+    {
+        report.size = file->get_len();
+        file->close();
+        memdelete(file);
+    }
+
+    reports.insert(report.id, report);
+    dirty = true;
+}
+
+void CrashpadReportIndex::add_report(const String &p_dump_path)
+{
+    ERR_FAIL_COND(opened == false);
+    if (reports.has(get_report_id_from_path(p_dump_path)) == true)
+    {
+        return;
+    }
+    _add_report(p_dump_path);
+}
+
+void CrashpadReportIndex::set_report_state(const String &p_id, ReportState p_state)
+{
+    Map<String, Report>::Element *E = reports.find(p_id);
+    ERR_FAIL_COND(E == nullptr);
+    E->get().state = p_state;
+    dirty = true;
+}
+
+void CrashpadReportIndex::increment_report_attempts(const String &p_id)
+{
+    Map<String, Report>::Element *E = reports.find(p_id);
+    ERR_FAIL_COND(E == nullptr);
+    E->get().attempts += 1;
+    dirty = true;
+}
+
+void CrashpadReportIndex::remove_report(const String &p_id, bool p_delete_files)
+{
+    Map<String, Report>::Element *E = reports.find(p_id);
+    if (E == nullptr)
+    {
+        return;
+    }
+    if (p_delete_files == true)
+    {
+        String dump_path = E->get().path;
+        DirAccess::remove_file_or_error(dump_path);
+        DirAccess::remove_file_or_error(dump_path.get_basename() + ".meta");
+        DirAccess::remove_file_or_error(dump_path.get_basename() + ".upload");
+    }
+    reports.erase(E);
+    dirty = true;
+}
+
+void CrashpadReportIndex::remove_all_reports()
+{
+    ERR_FAIL_COND(opened == false);
+    _remove_dump_files(database_path);
+    reports.clear();
+    pending_modified_time = 0;
+    dirty = true;
+}
+
+void CrashpadReportIndex::_remove_dump_files(const String &p_dir_path)
+{
+    DirAccess *dir = DirAccess::open(p_dir_path);
+    if (dir == nullptr)
+    {
+        return;
+    }
+    Vector<String> sub_dirs;
+    dir->list_dir_begin(true, false);
+    String file_name = dir->get_next();
+    while (file_name != "")
+    {
+        if (dir->current_is_dir() == true)
+        {
+            sub_dirs.push_back(p_dir_path.plus_file(file_name));
+        }
+        else if (file_name.ends_with(".dmp") || file_name.ends_with(".meta") || file_name.ends_with(".upload"))
+        {
+            DirAccess::remove_file_or_error(p_dir_path.plus_file(file_name));
+        }
+        file_name = dir->get_next();
+    }
+    dir->list_dir_end();
+    memdelete(dir);
+
+    for (int i = 0; i < sub_dirs.size(); i++)
+    {
+        _remove_dump_files(sub_dirs[i]);
+    }
+}
+
+bool CrashpadReportIndex::has_report(const String &p_id) const
+{
+    return reports.has(p_id);
+}
+
+CrashpadReportIndex::Report CrashpadReportIndex::get_report(const String &p_id) const
+{
+    const Map<String, Report>::Element *E = reports.find(p_id);
+    ERR_FAIL_COND_V(E == nullptr, Report());
+    return E->get();
+}
+
+Vector<String> CrashpadReportIndex::get_report_ids(ReportState p_state) const
+{
+    Vector<String> ids;
+    for (const Map<String, Report>::Element *E = reports.front(); E; E = E->next())
+    {
+        if (E->get().state == p_state)
+        {
+            ids.push_back(E->key());
+        }
+    }
+    return ids;
+}
+
+Vector<String> CrashpadReportIndex::get_all_report_ids() const
+{
+    Vector<String> ids;
+    for (const Map<String, Report>::Element *E = reports.front(); E; E = E->next())
+    {
+        ids.push_back(E->key());
+    }
+    return ids;
+}
+
+String CrashpadReportIndex::get_report_id_from_path(const String &p_dump_path)
+{
+    return p_dump_path.get_file().get_basename();
+}
+
+CrashpadReportIndex::CrashpadReportIndex()
+{
+}
@@ -0,0 +1,79 @@
+/* crashpad_report_index.h */
+
+#ifndef CRASHPAD_REPORT_INDEX_H
+#define CRASHPAD_REPORT_INDEX_H
+
+#include "core/map.h"
+#include "core/os/mutex.h"
+#include "core/ustring.h"
+#include "core/vector.h"
+
+// A small on-disk index of the crash reports in a Crashpad database.
+// It is kept up to date as reports are written and uploaded, so looking up
+// pending reports does not need a recursive walk of the database folders.
+// The "pending/" folder is only listed again when its modified time changed. File times only have
+// a resolution of a second, so a time that was not yet in the past when the folder was listed is not trusted.
+// The index is not thread safe by itself: callers on other threads have to hold lock() while using it.
+class CrashpadReportIndex {
+public:
+    enum ReportState {
+        REPORT_STATE_PENDING,
+        REPORT_STATE_UPLOADED,
+        REPORT_STATE_FAILED,
+    };
+
+    struct Report {
+        String id;
+        String path;
+        uint64_t size = 0;
+        ReportState state = REPORT_STATE_PENDING;
+        uint32_t attempts = 0;
+    };
+
+private:
+    String database_path;
+    String index_path;
+    Map<String, Report> reports;
+    uint64_t pending_modified_time = 0;
+    bool opened = false;
+    bool dirty = false;
+    Mutex mutex;
+
+    Error _load();
+    void _add_report(const String &p_dump_path);
+    static void _remove_dump_files(const String &p_dir_path);
+
+public:
+    void lock() { mutex.lock(); }
+    Error try_lock() { return mutex.try_lock(); }
+    void unlock() { mutex.unlock(); }
+
+    Error open(const String &p_database_path);
+    bool is_open() const { return opened; }
+    Error save();
+
+    // Picks up reports written by the handler that the index has not heard about yet, and forgets
+    // reports that are gone. Does a single listing of "pending/", and only if it changed since the last one.
+    void reconcile(bool p_force = false);
+
+    void add_report(const String &p_dump_path);
+    void set_report_state(const String &p_id, ReportState p_state);
+    void increment_report_attempts(const String &p_id);
+    // With p_delete_files, also deletes the ".dmp", its ".meta" and any ".upload" left by an interrupted upload
+    void remove_report(const String &p_id, bool p_delete_files);
+    // Forgets all reports and deletes every ".dmp", ".meta" and ".upload" file anywhere in the database,
+    // including dumps still in "new/" and the ones in "completed/" that the index does not track.
+    void remove_all_reports();
+
+    bool has_report(const String &p_id) const;
+    Report get_report(const String &p_id) const;
+    Vector<String> get_report_ids(ReportState p_state) const;
+    Vector<String> get_all_report_ids() const;
+    int get_report_count() const { return reports.size(); }
+
+    static String get_report_id_from_path(const String &p_dump_path);
+
+    CrashpadReportIndex();
+};
+
+#endif // CRASHPAD_REPORT_INDEX_H
@@ -0,0 +1,254 @@
+/* crashpad_screenshot.cpp */
+
+#include "crashpad_screenshot.h"
+#include "core/os/os.h"
+#include "scene/gui/texture_rect.h"
+#include "scene/main/viewport.h"
+
+// Smaller than this is not worth looking at
+#define CRASHPAD_SCREENSHOT_MIN_DIMENSION 32
+
+
+void CrashpadScreenshot::start()
+{
+    stop();
+
+    encoded.resize(MAX(max_bytes, 0));
+    encoded_size = 0;
+    next_capture_msec = 0;
+    readback_unsupported = false;
+    exit_requested.clear();
+    thread.start(_thread_func, this);
+}
+
+void CrashpadScreenshot::stop()
+{
+    if (thread.is_started())
+    {
+        exit_requested.set();
+        semaphore.post();
+        thread.wait_to_finish();
+    }
+    _free_downscale_viewport();
+    MutexLock lock(mutex);
+    pending.unref();
+}
+
+bool CrashpadScreenshot::is_running() const
+{
+    return thread.is_started();
+}
+
+void CrashpadScreenshot::poll(Node *p_owner)
+{
+    // The frame drawn by the last capture() is ready now
+    if (readback_pending == true)
+    {
+        _read_back();
+    }
+    uint64_t now = OS::get_singleton()->get_ticks_msec();
+    if (now < next_capture_msec)
+    {
+        return;
+    }
+    next_capture_msec = now + interval_msec;
+    capture(p_owner);
+}
+
+bool CrashpadScreenshot::capture(Node *p_owner)
+{
+    // Nothing is drawn headless (or while the window is minimized)
+    if (p_owner == nullptr || is_running() == false || readback_unsupported == true || OS::get_singleton()->can_draw() == false)
+    {
+        return false;
+    }
+    Viewport *source = p_owner->get_viewport();
+    if (source == nullptr || source->get_texture().is_null())
+    {
+        return false;
+    }
+    Size2 source_size = source->get_size();
+    if (source_size.width < 1 || source_size.height < 1)
+    {
+        return false;
+    }
+    float scale = MIN(1.0f, (float)max_dimension / MAX(source_size.width, source_size.height));
+    Size2 size(MAX((int)(source_size.width * scale), 1), MAX((int)(source_size.height * scale), 1));
+
+    Viewport *viewport = _get_downscale_viewport();
+    if (viewport == nullptr)
+    {
+        // Made once and only drawn when asked to, so the frames in between cost nothing
+        viewport = memnew(Viewport);
+        viewport->set_name("CrashpadScreenshot");
+        viewport->set_usage(Viewport::USAGE_2D);
+        viewport->set_disable_input(true);
+        viewport->set_update_mode(Viewport::UPDATE_DISABLED);
+        TextureRect *rect = memnew(TextureRect);
+        rect->set_expand(true);
+        rect->set_stretch_mode(TextureRect::STRETCH_SCALE);
+        viewport->add_child(rect);
+        p_owner->add_child(viewport);
+        downscale_viewport_id = viewport->get_instance_id();
+    }
+    TextureRect *rect = Object::cast_to<TextureRect>(viewport->get_child(0));
+    rect->set_texture(source->get_texture());
+    rect->set_size(size);
+    viewport->set_size(size);
+    viewport->set_update_mode(Viewport::UPDATE_ONCE);
+    readback_pending = true;
+    return true;
+}
+
+Viewport *CrashpadScreenshot::_get_downscale_viewport() const
+{
+    // Gone if its owner was freed
+    return downscale_viewport_id != 0 ? Object::cast_to<Viewport>(ObjectDB::get_instance(downscale_viewport_id)) : nullptr;
+}
+
+void CrashpadScreenshot::_free_downscale_viewport()
+{
+    Viewport *viewport = _get_downscale_viewport();
+    if (viewport != nullptr)
+    {
+        viewport->queue_delete();
+    }
+    downscale_viewport_id = 0;
+    readback_pending = false;
+}
+
+void CrashpadScreenshot::_read_back()
+{
+    readback_pending = false;
+    Viewport *viewport = _get_downscale_viewport();
+    if (viewport == nullptr)
+    {
+        return;
+    }
+    // The only part done on the main thread, and the only GPU work. The image is at most max_dimension.
+    Ref<Image> image = viewport->get_texture()->get_data();
+    if (image.is_null() || image->empty() == true)
+    {
+        // This renderer cannot read frames back, so do not try again
+        readback_unsupported = true;
+        _free_downscale_viewport();
+        return;
+    }
+
+    mutex.lock();
+    // An image the worker has not got to yet is simply replaced
+    pending = image;
+    mutex.unlock();
+    semaphore.post();
+}
+
+void CrashpadScreenshot::_encode(Ref<Image> p_image)
+{
+    if (Image::png_packer == nullptr || p_image->is_compressed() == true)
+    {
+        return;
+    }
+
+    // Viewport textures are upside down
+    p_image->flip_y();
+    p_image->clear_mipmaps();
+
+    int width = p_image->get_width();
+    int height = p_image->get_height();
+    float scale = MIN(1.0f, (float)max_dimension / MAX(width, height));
+    width = MAX((int)(width * scale), 1);
+    height = MAX((int)(height * scale), 1);
+
+    // Halve the size until the PNG fits the cap
+    PoolVector<uint8_t> png;
+    while (true)
+    {
+        if (width != p_image->get_width() || height != p_image->get_height())
+        {
+            p_image->resize(width, height, Image::INTERPOLATE_BILINEAR);
+        }
+        p_image->convert(Image::FORMAT_RGB8);
+        png = Image::png_packer(p_image);
+
+        // The packer puts Godot's own "PNG " tag in front of the file
+        int offset = 0;
+        if (png.size() >= 4)
+        {
+            PoolVector<uint8_t>::Read read = png.read();
+            if (read[0] == 'P' && read[1] == 'N' && read[2] == 'G' && read[3] == ' ')
+            {
+                offset = 4;
+            }
+        }
+
+        int png_size = png.size() - offset;
+        if (png_size > 0 && png_size <= encoded.size())
+        {
+            PoolVector<uint8_t>::Read read = png.read();
+            MutexLock lock(mutex);
+            memcpy(encoded.ptrw(), read.ptr() + offset, png_size);
+            encoded_size = png_size;
+            return;
+        }
+        if (MIN(width, height) / 2 < CRASHPAD_SCREENSHOT_MIN_DIMENSION)
+        {
+            return;
+        }
+        width /= 2;
+        height /= 2;
+    }
+}
+
+void CrashpadScreenshot::_thread_func(void *p_userdata)
+{
+    ((CrashpadScreenshot *)p_userdata)->_run();
+}
+
+void CrashpadScreenshot::_run()
+{
+    while (true)
+    {
+        semaphore.wait();
+        if (exit_requested.is_set() == true)
+        {
+            return;
+        }
+
+        mutex.lock();
+        Ref<Image> image = pending;
+        pending.unref();
+        mutex.unlock();
+
+        if (image.is_valid())
+        {
+            _encode(image);
+        }
+    }
+}
+
+bool CrashpadScreenshot::copy_latest(CharString &r_png)
+{
+    if (mutex.try_lock() != OK)
+    {
+        return false;
+    }
+    bool found = encoded_size > 0;
+    if (found == true)
+    {
+        // CharString counts its length without a terminator
+        r_png.resize(encoded_size + 1);
+        memcpy(r_png.ptrw(), encoded.ptr(), encoded_size);
+        r_png.ptrw()[encoded_size] = '\0';
+    }
+    mutex.unlock();
+    return found;
+}
+
+CrashpadScreenshot::CrashpadScreenshot()
+{
+}
+
+CrashpadScreenshot::~CrashpadScreenshot()
+{
+    stop();
+}
@@ -0,0 +1,71 @@
+/* crashpad_screenshot.h */
+
+#ifndef CRASHPAD_SCREENSHOT_H
+#define CRASHPAD_SCREENSHOT_H
+
+#include "core/image.h"
+#include "core/object.h"
+#include "core/os/mutex.h"
+#include "core/os/semaphore.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+#include "core/ustring.h"
+
+class Node;
+class Viewport;
+
+// A small PNG of a recent frame, ready to be attached when the game crashes.
+// Reading a frame back from the GPU is not possible from a crash handler, so the frame is read
+// on a slow cadence instead (nothing happens on the frames in between). The frame is first drawn
+// scaled down into a small viewport of its own, so only an image of at most max_dimension is read
+// back, on the frame after. A worker thread encodes it, shrinking it further until it fits the size
+// cap, into a buffer allocated once in start(). At crash time the last encoded image is only copied out.
+// Renderers that cannot read frames back (e.g. the dummy renderer of headless builds) give no image.
+class CrashpadScreenshot {
+    Thread thread;
+    Semaphore semaphore;
+    SafeFlag exit_requested;
+
+    // Guards everything below. The crash path only try_locks it.
+    Mutex mutex;
+    Ref<Image> pending;
+    Vector<uint8_t> encoded;
+    int encoded_size = 0;
+
+    // Main thread only. The small viewport is a child of the node that captures, and goes away with it.
+    uint64_t next_capture_msec = 0;
+    ObjectID downscale_viewport_id = 0;
+    bool readback_pending = false;
+    bool readback_unsupported = false;
+
+    Viewport *_get_downscale_viewport() const;
+    void _free_downscale_viewport();
+    void _read_back();
+    void _encode(Ref<Image> p_image);
+    void _run();
+    static void _thread_func(void *p_userdata);
+
+public:
+    int interval_msec = 10000;
+    // Longest side of the image, in pixels
+    int max_dimension = 640;
+    int max_bytes = 256 * 1024;
+
+    void start();
+    void stop();
+    bool is_running() const;
+
+    // Called once per frame on the main thread. Only draws and reads a frame back when the interval has passed.
+    void poll(Node *p_owner);
+    // Draws the current frame of the node's viewport scaled down now, to be read back and encoded on the
+    // next poll(). Main thread only. Returns false if nothing can be read back (headless, or the renderer gave no image).
+    bool capture(Node *p_owner);
+
+    // Copies the last encoded PNG. Returns false if there is none, or it is being replaced right now.
+    bool copy_latest(CharString &r_png);
+
+    CrashpadScreenshot();
+    ~CrashpadScreenshot();
+};
+
+#endif // CRASHPAD_SCREENSHOT_H
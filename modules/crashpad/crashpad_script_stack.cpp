@@ -0,0 +1,128 @@
+/* crashpad_script_stack.cpp */
+
+#include "crashpad_script_stack.h"
+#include "core/error_macros.h"
+#include "core/script_language.h"
+#include "crashpad_string_utils.h"
+
+ScriptDebugger *CrashpadScriptStack::debugger = nullptr;
+
+
+#ifdef DEBUG_ENABLED
+// Only there so the languages keep their call stacks
+class CrashpadScriptDebugger : public ScriptDebugger {
+public:
+    virtual void debug(ScriptLanguage *p_script, bool p_can_continue, bool p_is_error_breakpoint)
+    {
+        // With a debugger, script errors are sent here instead of being printed. "breakpoint" statements are ignored.
+        if (p_can_continue == true && p_is_error_breakpoint == true)
+        {
+            return;
+        }
+        String error = p_script->debug_get_error();
+        if (error.empty() == true)
+        {
+            return;
+        }
+        String function;
+        String source;
+        int line = 0;
+        if (p_script->debug_get_stack_level_count() > 0)
+        {
+            function = p_script->debug_get_stack_level_function(0);
+            source = p_script->debug_get_stack_level_source(0);
+            line = p_script->debug_get_stack_level_line(0);
+        }
+        _err_print_error(function.utf8().get_data(), source.utf8().get_data(), line, error.utf8().get_data(), ERR_HANDLER_SCRIPT);
+    }
+
+    virtual void send_message(const String &p_message, const Array &p_args) {}
+    virtual void send_error(const String &p_func, const String &p_file, int p_line, const String &p_err, const String &p_descr, ErrorHandlerType p_type, const Vector<ScriptLanguage::StackInfo> &p_stack_info) {}
+
+    virtual bool is_profiling() const { return false; }
+    virtual void add_profiling_frame_data(const StringName &p_name, const Array &p_data) {}
+    virtual void profiling_start() {}
+    virtual void profiling_end() {}
+    virtual void profiling_set_frame_times(float p_frame_time, float p_idle_time, float p_physics_time, float p_physics_frame_time) {}
+};
+#endif
+
+void CrashpadScriptStack::install_debugger()
+{
+#ifdef DEBUG_ENABLED
+    // A language created before this has no call stack to keep (GDScript sizes it in its constructor).
+    // Modules are registered in the order of their names, so this holds for "crashpad" and "gdscript",
+    // but not if the module is renamed or moved so that it comes after the script languages.
+    if (ScriptServer::get_language_count() != 0)
+    {
+        WARN_PRINT("The crashpad module was registered after the script languages, so script call stacks cannot be added to crash reports. Make sure it comes before them (e.g. keep its directory named \"crashpad\").");
+        return;
+    }
+    if (ScriptDebugger::get_singleton() == nullptr)
+    {
+        // Becomes the singleton
+        debugger = memnew(CrashpadScriptDebugger);
+    }
+#endif
+}
+
+void CrashpadScriptStack::uninstall_debugger()
+{
+    if (debugger != nullptr)
+    {
+        memdelete(debugger);
+        debugger = nullptr;
+    }
+}
+
+bool CrashpadScriptStack::is_own_debugger()
+{
+    return debugger != nullptr && ScriptDebugger::get_singleton() == debugger;
+}
+
+bool CrashpadScriptStack::is_available()
+{
+#ifdef DEBUG_ENABLED
+    return ScriptDebugger::get_singleton() != nullptr;
+#else
+    return false;
+#endif
+}
+
+static int _write_string(char *r_buffer, int p_position, int p_size, const String &p_string)
+{
+    if (p_position >= p_size)
+    {
+        return p_position;
+    }
+    return p_position + CrashpadStringUtils::copy_utf8(r_buffer + p_position, p_size - p_position, p_string);
+}
+
+int CrashpadScriptStack::write_text(char *r_buffer, int p_size)
+{
+    if (is_available() == false)
+    {
+        return 0;
+    }
+
+    // The stack levels only hold pointers, the strings they return share the script's own data
+    int position = 0;
+    for (int i = 0; i < ScriptServer::get_language_count(); i++)
+    {
+        ScriptLanguage *language = ScriptServer::get_language(i);
+        int level_count = language->debug_get_stack_level_count();
+        for (int level = 0; level < level_count && position < p_size; level++)
+        {
+            position = CrashpadStringUtils::write_text(r_buffer, position, p_size, "#");
+            position = CrashpadStringUtils::write_number(r_buffer, position, p_size, level);
+            position = CrashpadStringUtils::write_text(r_buffer, position, p_size, " ");
+            position = _write_string(r_buffer, position, p_size, language->debug_get_stack_level_source(level));
+            position = CrashpadStringUtils::write_text(r_buffer, position, p_size, ":");
+            position = CrashpadStringUtils::write_number(r_buffer, position, p_size, MAX(language->debug_get_stack_level_line(level), 0));
+            position = CrashpadStringUtils::write_text(r_buffer, position, p_size, " in ");
+            position = _write_string(r_buffer, position, p_size, language->debug_get_stack_level_function(level));
+            position = CrashpadStringUtils::write_text(r_buffer, position, p_size, "\n");
+        }
+    }
+    return position;
+}
@@ -0,0 +1,38 @@
+/* crashpad_script_stack.h */
+
+#ifndef CRASHPAD_SCRIPT_STACK_H
+#define CRASHPAD_SCRIPT_STACK_H
+
+#include "core/typedefs.h"
+
+class ScriptDebugger;
+
+// The script call stack (script, line and function of every level) of the main thread, for crash reports.
+// Godot only keeps it while a script debugger is active, and only in builds with DEBUG_ENABLED.
+// The languages keep it in a preallocated array with no allocation per call; entering a function
+// stores a few pointers. If no debugger was started (e.g. from the editor), install_debugger() adds
+// one that never stops the game and prints script errors like they are printed without a debugger.
+class CrashpadScriptStack {
+    static ScriptDebugger *debugger;
+
+public:
+    enum {
+        // Deep recursion is cut off, the innermost levels are the interesting ones
+        MAX_TEXT_SIZE = 8192,
+    };
+
+    // Has to run before the script languages are created (they size the call stack then),
+    // so it is called from register_types, and this module has to be registered before the script
+    // language modules. Does nothing if a debugger already exists, and warns if a language already exists.
+    static void install_debugger();
+    static void uninstall_debugger();
+    // True if the active debugger is the one from install_debugger(), which never stops at breakpoints
+    static bool is_own_debugger();
+    static bool is_available();
+
+    // Writes "#level source:line in function" lines, innermost first. Returns the number of bytes
+    // written (no null terminator). Does not allocate new strings and does not lock.
+    static int write_text(char *r_buffer, int p_size);
+};
+
+#endif // CRASHPAD_SCRIPT_STACK_H
@@ -0,0 +1,328 @@
+/* crashpad_session_tracker.cpp */
+
+#include "crashpad_session_tracker.h"
+#include "core/io/json.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+
+// Sessions beyond these are not worth keeping around, e.g. if the server is never reachable
+#define CRASHPAD_SESSION_MAX_PENDING 2000
+#define CRASHPAD_SESSION_MAX_BATCH 500
+// A claim this old belongs to a process that died while sending, so its sessions are sent again
+#define CRASHPAD_SESSION_CLAIM_TIMEOUT_SEC 3600
+
+
+void CrashpadSessionTracker::set_timeouts(int p_connect_timeout_msec, int p_total_timeout_msec)
+{
+    uploader.connect_timeout_msec = p_connect_timeout_msec;
+    uploader.total_timeout_msec = p_total_timeout_msec;
+}
+
+Error CrashpadSessionTracker::start(const String &p_database_path, const String &p_events_url, const Dictionary &p_attributes)
+{
+    ERR_FAIL_COND_V(session_id.empty() == false, ERR_ALREADY_IN_USE);
+
+    sessions_dir = p_database_path.plus_file("godot_sessions");
+    events_url = p_events_url;
+    attributes = p_attributes.duplicate();
+
+    DirAccess *dir = DirAccess::create(DirAccess::ACCESS_FILESYSTEM);
+    Error error = dir->make_dir_recursive(sessions_dir);
+    memdelete(dir);
+    if (error != OK)
+    {
+        return error;
+    }
+
+    install_id = _load_install_id(p_database_path);
+    String id = (install_id + itos(OS::get_singleton()->get_unix_time()) + itos(OS::get_singleton()->get_ticks_usec()) + itos(OS::get_singleton()->get_process_id())).md5_text();
+    session_path = sessions_dir.plus_file(id + ".session");
+    error = _append_line(session_path, "S " + itos(OS::get_singleton()->get_unix_time()));
+    if (error != OK)
+    {
+        return error;
+    }
+    session_id = id;
+
+    exit_requested.clear();
+    uploader.reset_cancel();
+    thread.start(_thread_func, this);
+    return OK;
+}
+
+void CrashpadSessionTracker::end()
+{
+    if (session_id.empty() == true)
+    {
+        return;
+    }
+
+    // Only this process writes its own file, so no other process can lose this line
+    _append_line(session_path, "E " + itos(OS::get_singleton()->get_unix_time()));
+
+    if (thread.is_started())
+    {
+        request_stop();
+        thread.wait_to_finish();
+    }
+    session_id = "";
+}
+
+void CrashpadSessionTracker::request_stop()
+{
+    exit_requested.set();
+    uploader.cancel();
+}
+
+String CrashpadSessionTracker::_load_install_id(const String &p_database_path)
+{
+    // Identifies this install (i.e. the user), so error-free users can be counted too
+    String install_id_path = p_database_path.plus_file("godot_install_id");
+    FileAccess *file = FileAccess::open(install_id_path, FileAccess::READ);
+    if (file != nullptr)
+    {
+        String id = file->get_line().strip_edges();
+        file->close();
+        memdelete(file);
+        if (id.empty() == false)
+        {
+            return id;
+        }
+    }
+
+    String id = (itos(OS::get_singleton()->get_unix_time()) + itos(OS::get_singleton()->get_ticks_usec()) + itos(OS::get_singleton()->get_process_id()) + OS::get_singleton()->get_unique_id()).md5_text();
+    file = FileAccess::open(install_id_path, FileAccess::WRITE);
+    if (file != nullptr)
+    {
+        file->store_line(id);
+        file->close();
+        memdelete(file);
+    }
+    return id;
+}
+
+Error CrashpadSessionTracker::_append_line(const String &p_path, const String &p_line)
+{
+    FileAccess *file = FileAccess::open(p_path, FileAccess::READ_WRITE);
+    if (file == nullptr)
+    {
+        file = FileAccess::open(p_path, FileAccess::WRITE);
+    }
+    if (file == nullptr)
+    {
+        return ERR_FILE_CANT_WRITE;
+    }
+    file->seek_end();
+    file->store_line(p_line);
+    file->close();
+    memdelete(file);
+    return OK;
+}
+
+bool CrashpadSessionTracker::_read_session(const String &p_path, Session &r_session)
+{
+    FileAccess *file = FileAccess::open(p_path, FileAccess::READ);
+    if (file == nullptr)
+    {
+        return false;
+    }
+    r_session.id = p_path.get_file().get_basename();
+    r_session.path = p_path;
+    while (file->eof_reached() == false)
+    {
+        Vector<String> parts = file->get_line().split(" ");
+        if (parts.size() != 2)
+        {
+            continue;
+        }
+        if (parts[0] == "S")
+        {
+            r_session.start_time = parts[1].to_int64();
+        }
+        else if (parts[0] == "E")
+        {
+            r_session.end_time = parts[1].to_int64();
+        }
+        else if (parts[0] == "C")
+        {
+            r_session.claim_time = parts[1].to_int64();
+        }
+    }
+    file->close();
+    memdelete(file);
+    // A file without its start line is still being created
+    return r_session.start_time != 0;
+}
+
+void CrashpadSessionTracker::_list_sessions(Vector<Session> &r_sessions)
+{
+    r_sessions.clear();
+    DirAccess *dir = DirAccess::open(sessions_dir);
+    if (dir == nullptr)
+    {
+        return;
+    }
+
+    uint64_t now = OS::get_singleton()->get_unix_time();
+    dir->list_dir_begin(true, false);
+    String file_name = dir->get_next();
+    while (file_name != "")
+    {
+        String path = sessions_dir.plus_file(file_name);
+        if (dir->current_is_dir() == false && file_name.ends_with(".sending"))
+        {
+            // Claimed by a process that is sending it, unless that process died while doing so
+            Session session;
+            if (_read_session(path, session) == true)
+            {
+                uint64_t claim_time = session.claim_time != 0 ? session.claim_time : FileAccess::get_modified_time(path);
+                if (now > claim_time + CRASHPAD_SESSION_CLAIM_TIMEOUT_SEC)
+                {
+                    dir->rename(path, sessions_dir.plus_file(session.id + ".session"));
+                }
+            }
+        }
+        else if (dir->current_is_dir() == false && file_name.ends_with(".session") && path != session_path)
+        {
+            Session session;
+            if (_read_session(path, session) == true)
+            {
+                r_sessions.push_back(session);
+            }
+        }
+        file_name = dir->get_next();
+    }
+    dir->list_dir_end();
+    memdelete(dir);
+    r_sessions.sort();
+}
+
+void CrashpadSessionTracker::_thread_func(void *p_userdata)
+{
+    CrashpadSessionTracker *self = (CrashpadSessionTracker *)p_userdata;
+    self->_flush();
+    self->uploader.close();
+}
+
+void CrashpadSessionTracker::_flush()
+{
+    Vector<Session> sessions;
+    _list_sessions(sessions);
+    if (sessions.size() > CRASHPAD_SESSION_MAX_PENDING)
+    {
+        // Keep the newest ones
+        Vector<Session> kept;
+        for (int i = 0; i < sessions.size(); i++)
+        {
+            if (i < sessions.size() - CRASHPAD_SESSION_MAX_PENDING)
+            {
+                DirAccess::remove_file_or_error(sessions[i].path);
+            }
+            else
+            {
+                kept.push_back(sessions[i]);
+            }
+        }
+        sessions = kept;
+    }
+
+    // Sessions of other processes sharing the database may still be running, unless they ended or are long gone
+    uint64_t now = OS::get_singleton()->get_unix_time();
+    Vector<Session> finished;
+    for (int i = 0; i < sessions.size() && finished.size() < CRASHPAD_SESSION_MAX_BATCH; i++)
+    {
+        bool abandoned = sessions[i].start_time <= now && now - sessions[i].start_time >= (uint64_t)abandoned_session_hours * 3600;
+        if (sessions[i].end_time != 0 || abandoned == true)
+        {
+            finished.push_back(sessions[i]);
+        }
+    }
+    if (finished.empty() == true || events_url.empty() == true)
+    {
+        return;
+    }
+    bool batch_due = finished.size() >= batch_size || now - finished[0].start_time >= (uint64_t)max_batch_age_hours * 3600;
+    if (batch_due == false || exit_requested.is_set())
+    {
+        return;
+    }
+
+    // Claim the sessions first. Whichever process renames a file first sends it.
+    DirAccess *dir = DirAccess::create_for_path(sessions_dir);
+    Vector<String> claimed_paths;
+    Array session_summaries;
+    for (int i = 0; i < finished.size(); i++)
+    {
+        const Session &session = finished[i];
+        String claimed_path = sessions_dir.plus_file(session.id + ".sending");
+        if (dir->rename(session.path, claimed_path) != OK)
+        {
+            continue;
+        }
+        _append_line(claimed_path, "C " + itos(now));
+        claimed_paths.push_back(claimed_path);
+
+        Dictionary summary;
+        summary["id"] = session.id;
+        summary["start"] = session.start_time;
+        if (session.end_time != 0)
+        {
+            summary["end"] = session.end_time;
+            summary["duration"] = session.end_time - session.start_time;
+            summary["status"] = "clean";
+        }
+        else
+        {
+            // Crashed, or was killed
+            summary["status"] = "abnormal";
+        }
+        session_summaries.push_back(summary);
+    }
+
+    Error error = OK;
+    int response_code = 0;
+    if (session_summaries.empty() == false)
+    {
+        Dictionary batch;
+        batch["install_id"] = install_id;
+        batch["attributes"] = attributes;
+        batch["sessions"] = session_summaries;
+
+        CrashpadMemoryBody body;
+        body.set_data(JSON::print(batch).utf8(), "application/json");
+        error = uploader.post(events_url, &body, Vector<String>(), response_code);
+    }
+    bool sent = error == OK && response_code >= 200 && response_code < 300;
+    if (sent == false && error != ERR_SKIP)
+    {
+        WARN_PRINT("Could not send session summaries! Error code: " + itos(error) + ", response code: " + itos(response_code));
+    }
+
+    for (int i = 0; i < claimed_paths.size(); i++)
+    {
+        if (sent == true)
+        {
+            DirAccess::remove_file_or_error(claimed_paths[i]);
+        }
+        else
+        {
+            // Kept for the next session to send
+            dir->rename(claimed_paths[i], claimed_paths[i].get_basename() + ".session");
+        }
+    }
+    memdelete(dir);
+}
+
+CrashpadSessionTracker::CrashpadSessionTracker()
+{
+}
+
+CrashpadSessionTracker::~CrashpadSessionTracker()
+{
+    if (thread.is_started())
+    {
+        request_stop();
+        thread.wait_to_finish();
+    }
+}
@@ -0,0 +1,71 @@
+/* crashpad_session_tracker.h */
+
+#ifndef CRASHPAD_SESSION_TRACKER_H
+#define CRASHPAD_SESSION_TRACKER_H
+
+#include "core/dictionary.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+#include "crashpad_uploader.h"
+
+// Records when sessions start and end, so the crash rate per session and per user can be worked out on the server.
+// Each session has its own small file next to the Crashpad database, written only by the process it belongs to,
+// so several game processes can share one database. A file with a start line but no end line is a session
+// that is still running, or that did not exit cleanly: it only counts as abnormal once it started
+// abandoned_session_hours ago. Finished sessions are sent as one batch on a worker thread once enough of
+// them piled up (or the oldest one waited long enough), never one request per session. A process claims
+// the files it sends by renaming them, so two processes never send the same session.
+class CrashpadSessionTracker {
+    struct Session {
+        String id;
+        String path;
+        uint64_t start_time = 0;
+        uint64_t end_time = 0;
+        uint64_t claim_time = 0;
+
+        bool operator<(const Session &p_other) const { return start_time < p_other.start_time; }
+    };
+
+    String sessions_dir;
+    String session_path;
+    String install_id;
+    String session_id;
+
+    Thread thread;
+    SafeFlag exit_requested;
+    CrashpadUploader uploader;
+    String events_url;
+    Dictionary attributes;
+
+    String _load_install_id(const String &p_database_path);
+    Error _append_line(const String &p_path, const String &p_line);
+    bool _read_session(const String &p_path, Session &r_session);
+    void _list_sessions(Vector<Session> &r_sessions);
+    void _flush();
+    static void _thread_func(void *p_userdata);
+
+public:
+    int batch_size = 20;
+    int max_batch_age_hours = 24;
+    // Sessions of other processes without an end line are only counted as crashed or killed after this long.
+    // Longer sessions (e.g. dedicated servers) need a higher value, or they are sent as abnormal while still running.
+    int abandoned_session_hours = 72;
+
+    void set_timeouts(int p_connect_timeout_msec, int p_total_timeout_msec);
+
+    // Records the start of this session, then sends the finished ones on a worker thread if a batch is due.
+    // Sending is skipped if the URL is empty.
+    Error start(const String &p_database_path, const String &p_events_url, const Dictionary &p_attributes);
+    // Records a clean end of this session and waits for the worker thread.
+    void end();
+    // Only asks the worker to stop, for use where joining a thread is not safe (e.g. while crashing).
+    void request_stop();
+
+    String get_session_id() const { return session_id; }
+    String get_install_id() const { return install_id; }
+
+    CrashpadSessionTracker();
+    ~CrashpadSessionTracker();
+};
+
+#endif // CRASHPAD_SESSION_TRACKER_H
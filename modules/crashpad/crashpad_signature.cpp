@@ -0,0 +1,288 @@
+/* crashpad_signature.cpp */
+
+#include "crashpad_signature.h"
+#include "core/os/file_access.h"
+
+#define MINIDUMP_SIGNATURE 0x504d444d // "MDMP"
+#define MINIDUMP_VERSION 0xa793
+
+#define MINIDUMP_STREAM_THREAD_LIST 3
+#define MINIDUMP_STREAM_MODULE_LIST 4
+#define MINIDUMP_STREAM_EXCEPTION 6
+#define MINIDUMP_STREAM_SYSTEM_INFO 7
+#define MINIDUMP_STREAM_MISC_INFO 15
+
+#define MINIDUMP_MISC1_PROCESS_ID 0x1
+
+#define MINIDUMP_CPU_X86 0
+#define MINIDUMP_CPU_AMD64 9
+#define MINIDUMP_CPU_ARM64 12
+#define MINIDUMP_CPU_ARM64_OLD 0x8003
+
+// Sizes of the fixed minidump records
+#define MINIDUMP_MODULE_SIZE 108
+#define MINIDUMP_THREAD_SIZE 48
+
+// Limits, so a broken dump cannot make us read forever
+#define CRASHPAD_SIGNATURE_MAX_STREAMS 256
+#define CRASHPAD_SIGNATURE_MAX_MODULES 4096
+#define CRASHPAD_SIGNATURE_MAX_THREADS 4096
+#define CRASHPAD_SIGNATURE_MAX_STACK_SCAN 16384
+
+
+struct CrashpadSignatureModule {
+    uint64_t base = 0;
+    uint64_t size = 0;
+    String name;
+};
+
+static String _read_minidump_string(FileAccess *p_file, uint32_t p_rva)
+{
+    p_file->seek(p_rva);
+    uint32_t length = p_file->get_32();
+    if (length > 4096 || p_file->eof_reached())
+    {
+        return "";
+    }
+    // UTF-16, which is only ever ASCII in practice for module paths
+    String name;
+    for (uint32_t i = 0; i < length / 2; i++)
+    {
+        name += (CharType)p_file->get_16();
+    }
+    return name;
+}
+
+static String _get_frame(const Vector<CrashpadSignatureModule> &p_modules, uint64_t p_address)
+{
+    for (int i = 0; i < p_modules.size(); i++)
+    {
+        if (p_address >= p_modules[i].base && p_address - p_modules[i].base < p_modules[i].size)
+        {
+            return p_modules[i].name + "+0x" + String::num_uint64(p_address - p_modules[i].base, 16);
+        }
+    }
+    return "";
+}
+
+Error CrashpadSignature::parse(const String &p_dump_path, int p_max_frames)
+{
+    exception_code = 0;
+    frames.clear();
+    hash = "";
+
+    FileAccess *file = FileAccess::open(p_dump_path, FileAccess::READ);
+    if (file == nullptr)
+    {
+        return ERR_FILE_CANT_OPEN;
+    }
+
+    if (file->get_32() != MINIDUMP_SIGNATURE || (file->get_32() & 0xFFFF) != MINIDUMP_VERSION)
+    {
+        file->close();
+        memdelete(file);
+        return ERR_FILE_UNRECOGNIZED;
+    }
+
+    // Find the streams we need
+    uint32_t stream_count = MIN(file->get_32(), (uint32_t)CRASHPAD_SIGNATURE_MAX_STREAMS);
+    uint32_t directory_rva = file->get_32();
+    uint32_t thread_list_rva = 0;
+    uint32_t module_list_rva = 0;
+    uint32_t exception_rva = 0;
+    uint32_t system_info_rva = 0;
+    for (uint32_t i = 0; i < stream_count; i++)
+    {
+        file->seek(directory_rva + i * 12);
+        uint32_t stream_type = file->get_32();
+        file->get_32(); // Size
+        uint32_t stream_rva = file->get_32();
+        if (stream_type == MINIDUMP_STREAM_THREAD_LIST)
+        {
+            thread_list_rva = stream_rva;
+        }
+        else if (stream_type == MINIDUMP_STREAM_MODULE_LIST)
+        {
+            module_list_rva = stream_rva;
+        }
+        else if (stream_type == MINIDUMP_STREAM_EXCEPTION)
+        {
+            exception_rva = stream_rva;
+        }
+        else if (stream_type == MINIDUMP_STREAM_SYSTEM_INFO)
+        {
+            system_info_rva = stream_rva;
+        }
+    }
+    if (exception_rva == 0 || module_list_rva == 0 || file->eof_reached())
+    {
+        // Not a crash (e.g. a dump taken without one), so there is nothing to sign
+        file->close();
+        memdelete(file);
+        return ERR_FILE_CORRUPT;
+    }
+
+    uint32_t architecture = MINIDUMP_CPU_AMD64;
+    if (system_info_rva != 0)
+    {
+        file->seek(system_info_rva);
+        architecture = file->get_16();
+    }
+
+    Vector<CrashpadSignatureModule> modules;
+    file->seek(module_list_rva);
+    uint32_t module_count = MIN(file->get_32(), (uint32_t)CRASHPAD_SIGNATURE_MAX_MODULES);
+    for (uint32_t i = 0; i < module_count; i++)
+    {
+        file->seek(module_list_rva + 4 + i * MINIDUMP_MODULE_SIZE);
+        CrashpadSignatureModule module;
+        module.base = file->get_64();
+        module.size = file->get_32();
+        file->get_32(); // CheckSum
+        file->get_32(); // TimeDateStamp
+        uint32_t name_rva = file->get_32();
+        module.name = _read_minidump_string(file, name_rva).replace("\\", "/").get_file().to_lower();
+        modules.push_back(module);
+    }
+
+    // The exception stream has the crashing thread and its context at the time of the crash
+    file->seek(exception_rva);
+    uint32_t thread_id = file->get_32();
+    file->get_32(); // Alignment
+    exception_code = file->get_32();
+    file->get_32(); // ExceptionFlags
+    file->get_64(); // ExceptionRecord
+    uint64_t exception_address = file->get_64();
+    file->seek(exception_rva + 160);
+    file->get_32(); // Context size
+    uint32_t context_rva = file->get_32();
+
+    uint64_t instruction_pointer = exception_address;
+    uint64_t stack_pointer = 0;
+    uint64_t link_register = 0;
+    int pointer_size = 8;
+    if (architecture == MINIDUMP_CPU_AMD64)
+    {
+        file->seek(context_rva + 152);
+        stack_pointer = file->get_64();
+        file->seek(context_rva + 248);
+        instruction_pointer = file->get_64();
+    }
+    else if (architecture == MINIDUMP_CPU_X86)
+    {
+        pointer_size = 4;
+        file->seek(context_rva + 184);
+        instruction_pointer = file->get_32();
+        file->seek(context_rva + 196);
+        stack_pointer = file->get_32();
+    }
+    else if (architecture == MINIDUMP_CPU_ARM64 || architecture == MINIDUMP_CPU_ARM64_OLD)
+    {
+        file->seek(context_rva + 248);
+        link_register = file->get_64();
+        stack_pointer = file->get_64();
+        instruction_pointer = file->get_64();
+    }
+
+    String frame = _get_frame(modules, instruction_pointer);
+    frames.push_back(frame.empty() ? String("<unknown>") : frame);
+    if (link_register != 0)
+    {
+        frame = _get_frame(modules, link_register);
+        if (frame.empty() == false)
+        {
+            frames.push_back(frame);
+        }
+    }
+
+    // Scan the top of the crashing thread's stack for return addresses
+    file->seek(thread_list_rva);
+    uint32_t thread_count = thread_list_rva == 0 ? 0 : MIN(file->get_32(), (uint32_t)CRASHPAD_SIGNATURE_MAX_THREADS);
+    for (uint32_t i = 0; i < thread_count && frames.size() < p_max_frames; i++)
+    {
+        file->seek(thread_list_rva + 4 + i * MINIDUMP_THREAD_SIZE);
+        if (file->get_32() != thread_id)
+        {
+            continue;
+        }
+        file->seek(thread_list_rva + 4 + i * MINIDUMP_THREAD_SIZE + 24);
+        uint64_t stack_start = file->get_64();
+        uint32_t stack_size = file->get_32();
+        uint32_t stack_rva = file->get_32();
+        if (stack_pointer < stack_start || stack_pointer - stack_start >= stack_size)
+        {
+            break;
+        }
+
+        uint64_t scan_offset = stack_pointer - stack_start;
+        uint64_t scan_end = MIN((uint64_t)stack_size, scan_offset + CRASHPAD_SIGNATURE_MAX_STACK_SCAN);
+        file->seek(stack_rva + scan_offset);
+        for (uint64_t offset = scan_offset; offset + pointer_size <= scan_end && frames.size() < p_max_frames; offset += pointer_size)
+        {
+            uint64_t value = pointer_size == 8 ? file->get_64() : file->get_32();
+            frame = _get_frame(modules, value);
+            if (frame.empty() == false)
+            {
+                frames.push_back(frame);
+            }
+        }
+        break;
+    }
+
+    bool broken = file->eof_reached();
+    file->close();
+    memdelete(file);
+    if (broken == true)
+    {
+        frames.clear();
+        return ERR_FILE_CORRUPT;
+    }
+
+    String text = String::num_uint64(exception_code, 16);
+    for (int i = 0; i < frames.size(); i++)
+    {
+        text += "|" + frames[i];
+    }
+    hash = text.md5_text();
+    return OK;
+}
+
+uint32_t CrashpadSignature::read_process_id(const String &p_dump_path)
+{
+    FileAccess *file = FileAccess::open(p_dump_path, FileAccess::READ);
+    if (file == nullptr)
+    {
+        return 0;
+    }
+    if (file->get_32() != MINIDUMP_SIGNATURE || (file->get_32() & 0xFFFF) != MINIDUMP_VERSION)
+    {
+        file->close();
+        memdelete(file);
+        return 0;
+    }
+
+    uint32_t stream_count = MIN(file->get_32(), (uint32_t)CRASHPAD_SIGNATURE_MAX_STREAMS);
+    uint32_t directory_rva = file->get_32();
+    uint32_t process_id = 0;
+    for (uint32_t i = 0; i < stream_count && file->eof_reached() == false; i++)
+    {
+        file->seek(directory_rva + i * 12);
+        if (file->get_32() != MINIDUMP_STREAM_MISC_INFO)
+        {
+            continue;
+        }
+        file->get_32(); // Size
+        file->seek(file->get_32());
+        file->get_32(); // SizeOfInfo
+        uint32_t flags = file->get_32();
+        uint32_t stream_process_id = file->get_32();
+        if ((flags & MINIDUMP_MISC1_PROCESS_ID) != 0 && file->eof_reached() == false)
+        {
+            process_id = stream_process_id;
+        }
+        break;
+    }
+    file->close();
+    memdelete(file);
+    return process_id;
+}
@@ -0,0 +1,26 @@
+/* crashpad_signature.h */
+
+#ifndef CRASHPAD_SIGNATURE_H
+#define CRASHPAD_SIGNATURE_H
+
+#include "core/ustring.h"
+#include "core/vector.h"
+
+// A cheap signature of a crash, read straight from a minidump without symbols.
+// The frames are the crashing instruction followed by the return addresses found by scanning
+// the top of the crashing thread's stack, each written as "module+offset" so they do not depend
+// on where the modules were loaded. Stack scanning can pick up stale addresses, but the same bug
+// leaves the same ones, which is all a signature needs.
+class CrashpadSignature {
+public:
+    uint32_t exception_code = 0;
+    Vector<String> frames;
+    String hash;
+
+    Error parse(const String &p_dump_path, int p_max_frames);
+
+    // The id of the process the dump was taken of, or 0 if the dump does not say
+    static uint32_t read_process_id(const String &p_dump_path);
+};
+
+#endif // CRASHPAD_SIGNATURE_H
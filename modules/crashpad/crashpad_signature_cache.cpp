@@ -0,0 +1,130 @@
+/* crashpad_signature_cache.cpp */
+
+#include "crashpad_signature_cache.h"
+#include "crashpad_state_file.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+
+#define CRASHPAD_SIGNATURE_CACHE_MAGIC 0x53534347 // "GCSS"
+#define CRASHPAD_SIGNATURE_CACHE_VERSION 1
+
+
+Error CrashpadSignatureCache::open(const String &p_database_path)
+{
+    database_path = p_database_path;
+    cache_path = database_path.plus_file("godot_signature_cache.dat");
+    entries.clear();
+    dirty = false;
+
+    // A missing or broken cache only means the next crash of each kind is uploaded in full
+    if (_load() != OK)
+    {
+        entries.clear();
+    }
+    opened = true;
+    return OK;
+}
+
+Error CrashpadSignatureCache::_load()
+{
+    Error error = OK;
+    FileAccess *file = CrashpadStateFile::open_for_read(cache_path, CRASHPAD_SIGNATURE_CACHE_MAGIC, CRASHPAD_SIGNATURE_CACHE_VERSION, error);
+    if (file == nullptr)
+    {
+        return error;
+    }
+
+    uint32_t entry_count = file->get_32();
+    for (uint32_t i = 0; i < entry_count; i++)
+    {
+        String signature = file->get_pascal_string();
+        Entry entry;
+        entry.reported_time = file->get_64();
+        entry.duplicate_count = file->get_32();
+        if (file->eof_reached())
+        {
+            file->close();
+            memdelete(file);
+            return ERR_FILE_CORRUPT;
+        }
+        entries.insert(signature, entry);
+    }
+
+    file->close();
+    memdelete(file);
+    return OK;
+}
+
+Error CrashpadSignatureCache::save(uint64_t p_window_sec)
+{
+    ERR_FAIL_COND_V(opened == false, ERR_UNCONFIGURED);
+
+    uint64_t now = OS::get_singleton()->get_unix_time();
+    Vector<String> expired;
+    for (Map<String, Entry>::Element *E = entries.front(); E; E = E->next())
+    {
+        if (now - E->get().reported_time >= p_window_sec)
+        {
+            expired.push_back(E->key());
+        }
+    }
+    for (int i = 0; i < expired.size(); i++)
+    {
+        entries.erase(expired[i]);
+        dirty = true;
+    }
+    if (dirty == false)
+    {
+        return OK;
+    }
+
+    FileAccess *file = CrashpadStateFile::begin_save(cache_path, CRASHPAD_SIGNATURE_CACHE_MAGIC, CRASHPAD_SIGNATURE_CACHE_VERSION);
+    if (file == nullptr)
+    {
+        return ERR_FILE_CANT_WRITE;
+    }
+    file->store_32(entries.size());
+    for (Map<String, Entry>::Element *E = entries.front(); E; E = E->next())
+    {
+        file->store_pascal_string(E->key());
+        file->store_64(E->get().reported_time);
+        file->store_32(E->get().duplicate_count);
+    }
+    Error error = CrashpadStateFile::end_save(file, cache_path);
+    if (error == OK)
+    {
+        dirty = false;
+    }
+    return error;
+}
+
+bool CrashpadSignatureCache::is_recently_reported(const String &p_signature, uint64_t p_window_sec) const
+{
+    const Map<String, Entry>::Element *E = entries.find(p_signature);
+    if (E == nullptr)
+    {
+        return false;
+    }
+    return OS::get_singleton()->get_unix_time() - E->get().reported_time < p_window_sec;
+}
+
+void CrashpadSignatureCache::record_report(const String &p_signature)
+{
+    Entry entry;
+    entry.reported_time = OS::get_singleton()->get_unix_time();
+    entries[p_signature] = entry;
+    dirty = true;
+}
+
+uint32_t CrashpadSignatureCache::record_duplicate(const String &p_signature)
+{
+    Map<String, Entry>::Element *E = entries.find(p_signature);
+    ERR_FAIL_NULL_V(E, 0);
+    E->get().duplicate_count += 1;
+    dirty = true;
+    return E->get().duplicate_count;
+}
+
+CrashpadSignatureCache::CrashpadSignatureCache()
+{
+}
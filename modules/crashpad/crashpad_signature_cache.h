@@ -0,0 +1,47 @@
+/* crashpad_signature_cache.h */
+
+#ifndef CRASHPAD_SIGNATURE_CACHE_H
+#define CRASHPAD_SIGNATURE_CACHE_H
+
+#include "core/map.h"
+#include "core/os/mutex.h"
+#include "core/ustring.h"
+
+// Remembers which crash signatures this install has already uploaded a full dump for, and when.
+// Stored next to the Crashpad database, so repeats are recognised across sessions.
+// Like the report index, callers on other threads have to hold lock() while using it.
+class CrashpadSignatureCache {
+    struct Entry {
+        uint64_t reported_time = 0;
+        uint32_t duplicate_count = 0;
+    };
+
+    String database_path;
+    String cache_path;
+    Map<String, Entry> entries;
+    bool opened = false;
+    bool dirty = false;
+    Mutex mutex;
+
+    Error _load();
+
+public:
+    void lock() { mutex.lock(); }
+    Error try_lock() { return mutex.try_lock(); }
+    void unlock() { mutex.unlock(); }
+
+    Error open(const String &p_database_path);
+    bool is_open() const { return opened; }
+    // Also forgets signatures whose window has passed
+    Error save(uint64_t p_window_sec);
+
+    // True if a full dump with this signature was uploaded less than p_window_sec seconds ago
+    bool is_recently_reported(const String &p_signature, uint64_t p_window_sec) const;
+    void record_report(const String &p_signature);
+    // Returns how many duplicates of the signature there were since its last full dump, this one included
+    uint32_t record_duplicate(const String &p_signature);
+
+    CrashpadSignatureCache();
+};
+
+#endif // CRASHPAD_SIGNATURE_CACHE_H
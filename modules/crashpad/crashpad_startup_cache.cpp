@@ -0,0 +1,79 @@
+/* crashpad_startup_cache.cpp */
+
+#include "crashpad_startup_cache.h"
+#include "crashpad_state_file.h"
+#include "core/os/dir_access.h"
+#include "core/os/file_access.h"
+#include "core/os/os.h"
+
+#define CRASHPAD_STARTUP_CACHE_MAGIC 0x43534347 // "GCSC"
+#define CRASHPAD_STARTUP_CACHE_VERSION 2
+
+
+Error CrashpadStartupCache::load(const String &p_cache_path)
+{
+    Error error = OK;
+    FileAccess *file = CrashpadStateFile::open_for_read(p_cache_path, CRASHPAD_STARTUP_CACHE_MAGIC, CRASHPAD_STARTUP_CACHE_VERSION, error);
+    if (file == nullptr)
+    {
+        return error;
+    }
+
+    settings_key = file->get_pascal_string();
+    handler_path = file->get_pascal_string();
+    database_path = file->get_pascal_string();
+    handler_modified_time = file->get_64();
+    last_start_ok = file->get_8() != 0;
+    bool corrupt = file->eof_reached();
+    file->close();
+    memdelete(file);
+
+    if (corrupt == true)
+    {
+        last_start_ok = false;
+        return ERR_FILE_CORRUPT;
+    }
+    return OK;
+}
+
+Error CrashpadStartupCache::save(const String &p_cache_path) const
+{
+    FileAccess *file = CrashpadStateFile::begin_save(p_cache_path, CRASHPAD_STARTUP_CACHE_MAGIC, CRASHPAD_STARTUP_CACHE_VERSION);
+    if (file == nullptr)
+    {
+        return ERR_FILE_CANT_WRITE;
+    }
+    file->store_pascal_string(settings_key);
+    file->store_pascal_string(handler_path);
+    file->store_pascal_string(database_path);
+    file->store_64(handler_modified_time);
+    file->store_8(last_start_ok ? 1 : 0);
+    return CrashpadStateFile::end_save(file, p_cache_path);
+}
+
+bool CrashpadStartupCache::is_valid_for(const String &p_settings_key) const
+{
+    if (settings_key != p_settings_key || handler_path.empty() == true || database_path.empty() == true)
+    {
+        return false;
+    }
+    // 0 if the handler is gone. A replaced handler gets a new modification time.
+    uint64_t modified_time = FileAccess::get_modified_time(handler_path);
+    if (modified_time == 0 || modified_time != handler_modified_time)
+    {
+        return false;
+    }
+    // A deleted database is made again by the full check
+    return DirAccess::exists(database_path);
+}
+
+Error CrashpadStartupCache::update_handler_info()
+{
+    handler_modified_time = FileAccess::get_modified_time(handler_path);
+    return handler_modified_time != 0 ? OK : ERR_FILE_NOT_FOUND;
+}
+
+String CrashpadStartupCache::get_default_path()
+{
+    return OS::get_singleton()->get_user_data_dir().plus_file("godot_crashpad_startup.cache");
+}
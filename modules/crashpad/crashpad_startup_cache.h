@@ -0,0 +1,32 @@
+/* crashpad_startup_cache.h */
+
+#ifndef CRASHPAD_STARTUP_CACHE_H
+#define CRASHPAD_STARTUP_CACHE_H
+
+#include "core/ustring.h"
+
+// What start_crashpad() resolved on the last launch: the global handler and database paths, which
+// handler binary it was (its modification time) and whether the handler started with them.
+// While the settings and the handler binary are unchanged, a launch only has to check the handler's
+// modification time and that the database is still there, instead of resolving the paths again.
+class CrashpadStartupCache {
+public:
+    // The settings the paths were resolved from
+    String settings_key;
+    String handler_path;
+    String database_path;
+    uint64_t handler_modified_time = 0;
+    bool last_start_ok = false;
+
+    Error load(const String &p_cache_path);
+    Error save(const String &p_cache_path) const;
+
+    // Costs one stat of the handler binary and one of the database directory
+    bool is_valid_for(const String &p_settings_key) const;
+    // Fills in the handler modification time from the file itself
+    Error update_handler_info();
+
+    static String get_default_path();
+};
+
+#endif // CRASHPAD_STARTUP_CACHE_H
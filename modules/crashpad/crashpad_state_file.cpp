@@ -0,0 +1,48 @@
+/* crashpad_state_file.cpp */
+
+#include "crashpad_state_file.h"
+#include "core/os/dir_access.h"
+
+FileAccess *CrashpadStateFile::open_for_read(const String &p_path, uint32_t p_magic, uint32_t p_version, Error &r_error)
+{
+    FileAccess *file = FileAccess::open(p_path, FileAccess::READ);
+    if (file == nullptr)
+    {
+        r_error = ERR_FILE_NOT_FOUND;
+        return nullptr;
+    }
+
+    if (file->get_32() != p_magic || file->get_32() != p_version)
+    {
+        file->close();
+        memdelete(file);
+        r_error = ERR_FILE_UNRECOGNIZED;
+        return nullptr;
+    }
+    r_error = OK;
+    return file;
+}
+
+FileAccess *CrashpadStateFile::begin_save(const String &p_path, uint32_t p_magic, uint32_t p_version)
+{
+    // Write to a temporary file first, so a crash while saving never leaves a half written file behind
+    FileAccess *file = FileAccess::open(p_path + ".tmp", FileAccess::WRITE);
+    if (file == nullptr)
+    {
+        return nullptr;
+    }
+    file->store_32(p_magic);
+    file->store_32(p_version);
+    return file;
+}
+
+Error CrashpadStateFile::end_save(FileAccess *p_file, const String &p_path)
+{
+    p_file->close();
+    memdelete(p_file);
+
+    DirAccess *dir = DirAccess::create_for_path(p_path.get_base_dir());
+    Error error = dir->rename(p_path + ".tmp", p_path);
+    memdelete(dir);
+    return error;
+}
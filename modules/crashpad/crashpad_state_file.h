@@ -0,0 +1,25 @@
+/* crashpad_state_file.h */
+
+#ifndef CRASHPAD_STATE_FILE_H
+#define CRASHPAD_STATE_FILE_H
+
+#include "core/os/file_access.h"
+#include "core/ustring.h"
+
+// The small binary files the module keeps next to the database (report index, rate limits, signature cache,
+// startup cache). Each starts with a magic number and a format version, and is saved whole to a temporary
+// file that then replaces the old one.
+class CrashpadStateFile {
+public:
+    // Opens the file and checks its header. Returns nullptr with ERR_FILE_NOT_FOUND, or ERR_FILE_UNRECOGNIZED
+    // for another format or version, in r_error. The caller reads the rest, then closes and frees the file.
+    static FileAccess *open_for_read(const String &p_path, uint32_t p_magic, uint32_t p_version, Error &r_error);
+
+    // Starts saving: returns a file with the header written, for the caller to write the rest into.
+    // Returns nullptr if it cannot be created.
+    static FileAccess *begin_save(const String &p_path, uint32_t p_magic, uint32_t p_version);
+    // Closes and frees the file from begin_save(), and puts it in place of the old one.
+    static Error end_save(FileAccess *p_file, const String &p_path);
+};
+
+#endif // CRASHPAD_STATE_FILE_H
@@ -0,0 +1,137 @@
+/* crashpad_string_utils.cpp */
+
+#include "crashpad_string_utils.h"
+
+// Used for invalid input, like a lone UTF-16 surrogate
+#define CRASHPAD_REPLACEMENT_CHARACTER 0xFFFD
+
+
+uint32_t CrashpadStringUtils::_next_code_point(const CharType *p_source, int &r_index)
+{
+    uint32_t c = (uint32_t)p_source[r_index];
+    r_index++;
+
+    // wchar_t is UTF-16 on Windows, so characters outside the BMP come as surrogate pairs
+    if (c >= 0xD800 && c <= 0xDBFF)
+    {
+        uint32_t low = (uint32_t)p_source[r_index];
+        if (low >= 0xDC00 && low <= 0xDFFF)
+        {
+            r_index++;
+            return 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+        }
+        return CRASHPAD_REPLACEMENT_CHARACTER;
+    }
+    if ((c >= 0xDC00 && c <= 0xDFFF) || c > 0x10FFFF)
+    {
+        return CRASHPAD_REPLACEMENT_CHARACTER;
+    }
+    return c;
+}
+
+static int _get_encoded_length(uint32_t p_code_point)
+{
+    return p_code_point < 0x80 ? 1 : (p_code_point < 0x800 ? 2 : (p_code_point < 0x10000 ? 3 : 4));
+}
+
+int CrashpadStringUtils::copy_utf8(char *r_buffer, int p_size, const String &p_string)
+{
+    if (p_size <= 0)
+    {
+        return 0;
+    }
+
+    const CharType *source = p_string.c_str();
+    int position = 0;
+    int index = 0;
+    while (source[index] != 0)
+    {
+        uint32_t c = _next_code_point(source, index);
+        int length = _get_encoded_length(c);
+        if (position + length >= p_size)
+        {
+            break;
+        }
+        if (length == 1)
+        {
+            r_buffer[position++] = c;
+        }
+        else if (length == 2)
+        {
+            r_buffer[position++] = 0xC0 | (c >> 6);
+            r_buffer[position++] = 0x80 | (c & 0x3F);
+        }
+        else if (length == 3)
+        {
+            r_buffer[position++] = 0xE0 | (c >> 12);
+            r_buffer[position++] = 0x80 | ((c >> 6) & 0x3F);
+            r_buffer[position++] = 0x80 | (c & 0x3F);
+        }
+        else
+        {
+            r_buffer[position++] = 0xF0 | (c >> 18);
+            r_buffer[position++] = 0x80 | ((c >> 12) & 0x3F);
+            r_buffer[position++] = 0x80 | ((c >> 6) & 0x3F);
+            r_buffer[position++] = 0x80 | (c & 0x3F);
+        }
+    }
+    r_buffer[position] = '\0';
+    return position;
+}
+
+int CrashpadStringUtils::get_utf8_length(const String &p_string)
+{
+    const CharType *source = p_string.c_str();
+    int length = 0;
+    int index = 0;
+    while (source[index] != 0)
+    {
+        length += _get_encoded_length(_next_code_point(source, index));
+    }
+    return length;
+}
+
+std::string CrashpadStringUtils::to_std_string(const String &p_string)
+{
+    int length = get_utf8_length(p_string);
+    // std::string keeps room for its own terminator past size(), which copy_utf8 writes into
+    std::string result(length, '\0');
+    copy_utf8(&result[0], length + 1, p_string);
+    return result;
+}
+
+int CrashpadStringUtils::write_text(char *r_buffer, int p_position, int p_size, const char *p_text)
+{
+    while (*p_text != '\0' && p_position < p_size)
+    {
+        r_buffer[p_position++] = *p_text++;
+    }
+    return p_position;
+}
+
+int CrashpadStringUtils::write_number(char *r_buffer, int p_position, int p_size, uint64_t p_number)
+{
+    char digits[21];
+    int count = 0;
+    do
+    {
+        digits[count++] = '0' + (p_number % 10);
+        p_number /= 10;
+    } while (p_number > 0);
+    while (count > 0 && p_position < p_size)
+    {
+        r_buffer[p_position++] = digits[--count];
+    }
+    return p_position;
+}
+
+int CrashpadStringUtils::get_number_length(uint64_t p_number)
+{
+    int length = 1;
+    while (p_number >= 10)
+    {
+        p_number /= 10;
+        length++;
+    }
+    return length;
+}
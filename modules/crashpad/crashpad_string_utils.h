@@ -0,0 +1,34 @@
+/* crashpad_string_utils.h */
+
+#ifndef CRASHPAD_STRING_UTILS_H
+#define CRASHPAD_STRING_UTILS_H
+
+#include "core/ustring.h"
+
+#include <string>
+
+// UTF-8 conversion of Godot strings for Crashpad, which takes UTF-8 everywhere except
+// for file paths on Windows. Unlike String::utf8(), the buffer versions never allocate,
+// so they can be used for frequent updates and at crash time.
+class CrashpadStringUtils {
+    static uint32_t _next_code_point(const CharType *p_source, int &r_index);
+
+public:
+    // Encodes p_string as UTF-8 into r_buffer, always null terminated. Stops before a character
+    // that would not fit, so the result is never cut in the middle of a character.
+    // Returns the number of bytes written, without the terminator.
+    static int copy_utf8(char *r_buffer, int p_size, const String &p_string);
+    // The number of bytes the UTF-8 form of p_string takes, without a terminator.
+    static int get_utf8_length(const String &p_string);
+    // Converts with a single allocation, for the Crashpad APIs that take std::string.
+    static std::string to_std_string(const String &p_string);
+
+    // For writing text at crash time: append to r_buffer at p_position, never past p_size,
+    // and return the new position. No null terminator is written.
+    static int write_text(char *r_buffer, int p_position, int p_size, const char *p_text);
+    static int write_number(char *r_buffer, int p_position, int p_size, uint64_t p_number);
+    // The number of digits write_number() writes for p_number
+    static int get_number_length(uint64_t p_number);
+};
+
+#endif // CRASHPAD_STRING_UTILS_H
@@ -0,0 +1,177 @@
+/* crashpad_telemetry.cpp */
+
+#include "crashpad_telemetry.h"
+#include "core/os/memory.h"
+#include "core/os/os.h"
+#include "crashpad_string_utils.h"
+#include "main/performance.h"
+
+static const char *_metric_names[CrashpadTelemetry::METRIC_MAX] = {
+    "frame_time_usec",
+    "physics_time_usec",
+    "static_memory_bytes",
+    "dynamic_memory_bytes",
+    "objects",
+    "nodes",
+    "draw_calls",
+    "video_memory_bytes",
+};
+
+
+void CrashpadTelemetry::start(int p_capacity, uint32_t p_metric_flags, int p_interval_msec)
+{
+    stop();
+
+    capacity = CLAMP(p_capacity, 1, (int)MAX_CAPACITY);
+    samples = memnew_arr(Sample, capacity);
+    metric_count = 0;
+    for (int i = 0; i < METRIC_MAX; i++)
+    {
+        if ((p_metric_flags & (1 << i)) != 0)
+        {
+            metrics[metric_count++] = (Metric)i;
+        }
+    }
+    interval_msec = MAX(p_interval_msec, 0);
+    next_sample_msec = 0;
+    sample_count.store(0, std::memory_order_release);
+}
+
+void CrashpadTelemetry::stop()
+{
+    if (samples != nullptr)
+    {
+        memdelete_arr(samples);
+        samples = nullptr;
+    }
+    capacity = 0;
+    sample_count.store(0, std::memory_order_release);
+}
+
+uint64_t CrashpadTelemetry::_read_metric(Metric p_metric)
+{
+    Performance *performance = Performance::get_singleton();
+    switch (p_metric)
+    {
+        case METRIC_FRAME_TIME:
+            return (uint64_t)(performance->get_monitor(Performance::TIME_PROCESS) * 1000000.0);
+        case METRIC_PHYSICS_TIME:
+            return (uint64_t)(performance->get_monitor(Performance::TIME_PHYSICS_PROCESS) * 1000000.0);
+        case METRIC_STATIC_MEMORY:
+            return (uint64_t)performance->get_monitor(Performance::MEMORY_STATIC);
+        case METRIC_DYNAMIC_MEMORY:
+            return (uint64_t)performance->get_monitor(Performance::MEMORY_DYNAMIC);
+        case METRIC_OBJECTS:
+            return (uint64_t)performance->get_monitor(Performance::OBJECT_COUNT);
+        case METRIC_NODES:
+            return (uint64_t)performance->get_monitor(Performance::OBJECT_NODE_COUNT);
+        case METRIC_DRAW_CALLS:
+            return (uint64_t)performance->get_monitor(Performance::RENDER_DRAW_CALLS_IN_FRAME);
+        case METRIC_VIDEO_MEMORY:
+            return (uint64_t)performance->get_monitor(Performance::RENDER_VIDEO_MEM_USED);
+        default:
+            return 0;
+    }
+}
+
+void CrashpadTelemetry::sample()
+{
+    uint64_t now = OS::get_singleton()->get_ticks_msec();
+    if (now < next_sample_msec)
+    {
+        return;
+    }
+    next_sample_msec = now + interval_msec;
+
+    // Only the main thread writes, so the count is only published once the slot is complete
+    uint64_t index = sample_count.load(std::memory_order_relaxed);
+    Sample &slot = samples[index % capacity];
+    slot.time_msec = now;
+    for (int i = 0; i < metric_count; i++)
+    {
+        slot.values[i] = _read_metric(metrics[i]);
+    }
+    sample_count.store(index + 1, std::memory_order_release);
+}
+
+int CrashpadTelemetry::_get_row_length(const Sample &p_sample) const
+{
+    // time "," value ... "\n"
+    int length = CrashpadStringUtils::get_number_length(p_sample.time_msec) + 1;
+    for (int i = 0; i < metric_count; i++)
+    {
+        length += 1 + CrashpadStringUtils::get_number_length(p_sample.values[i]);
+    }
+    return length;
+}
+
+int CrashpadTelemetry::write_csv(char *r_buffer, int p_size) const
+{
+    if (samples == nullptr)
+    {
+        return 0;
+    }
+
+    int header_length = strlen("time_msec") + 1;
+    for (int i = 0; i < metric_count; i++)
+    {
+        header_length += 1 + strlen(_metric_names[metrics[i]]);
+    }
+    if (header_length > p_size)
+    {
+        return 0;
+    }
+
+    // Find how many of the newest samples fit
+    uint64_t end = sample_count.load(std::memory_order_acquire);
+    uint64_t begin = end > (uint64_t)capacity ? end - capacity : 0;
+    uint64_t first = end;
+    int total_length = header_length;
+    while (first > begin)
+    {
+        int row_length = _get_row_length(samples[(first - 1) % capacity]);
+        if (total_length + row_length > p_size)
+        {
+            break;
+        }
+        total_length += row_length;
+        first--;
+    }
+
+    int position = CrashpadStringUtils::write_text(r_buffer, 0, p_size, "time_msec");
+    for (int i = 0; i < metric_count; i++)
+    {
+        position = CrashpadStringUtils::write_text(r_buffer, position, p_size, ",");
+        position = CrashpadStringUtils::write_text(r_buffer, position, p_size, _metric_names[metrics[i]]);
+    }
+    position = CrashpadStringUtils::write_text(r_buffer, position, p_size, "\n");
+
+    for (uint64_t index = first; index < end; index++)
+    {
+        const Sample &sample = samples[index % capacity];
+        position = CrashpadStringUtils::write_number(r_buffer, position, p_size, sample.time_msec);
+        for (int i = 0; i < metric_count; i++)
+        {
+            position = CrashpadStringUtils::write_text(r_buffer, position, p_size, ",");
+            position = CrashpadStringUtils::write_number(r_buffer, position, p_size, sample.values[i]);
+        }
+        position = CrashpadStringUtils::write_text(r_buffer, position, p_size, "\n");
+    }
+    return position;
+}
+
+int CrashpadTelemetry::get_max_csv_size() const
+{
+    // Each number is at most 20 digits, plus its separator
+    return (capacity + 1) * (METRIC_MAX + 1) * 21;
+}
+
+CrashpadTelemetry::CrashpadTelemetry() :
+        sample_count(0)
+{
+}
+
+CrashpadTelemetry::~CrashpadTelemetry()
+{
+    stop();
+}
@@ -0,0 +1,70 @@
+/* crashpad_telemetry.h */
+
+#ifndef CRASHPAD_TELEMETRY_H
+#define CRASHPAD_TELEMETRY_H
+
+#include "core/typedefs.h"
+
+#include <atomic>
+
+// A fixed size ring of recent engine monitor samples (frame time, memory, object counts...),
+// so a crash that follows a memory spike or a frame time collapse shows it.
+// The ring is allocated once in start(). Taking a sample reads the enabled Performance monitors
+// into the next slot, with no allocation and no locking. At crash time the ring is written out as CSV.
+class CrashpadTelemetry {
+public:
+    enum Metric {
+        METRIC_FRAME_TIME, // usec
+        METRIC_PHYSICS_TIME, // usec
+        METRIC_STATIC_MEMORY, // bytes
+        METRIC_DYNAMIC_MEMORY, // bytes
+        METRIC_OBJECTS,
+        METRIC_NODES,
+        METRIC_DRAW_CALLS,
+        METRIC_VIDEO_MEMORY, // bytes
+        METRIC_MAX,
+    };
+
+    enum {
+        MAX_CAPACITY = 4096,
+    };
+
+private:
+    struct Sample {
+        uint64_t time_msec;
+        uint64_t values[METRIC_MAX];
+    };
+
+    Sample *samples = nullptr;
+    int capacity = 0;
+    // The enabled metrics, in column order
+    Metric metrics[METRIC_MAX];
+    int metric_count = 0;
+    std::atomic<uint64_t> sample_count;
+    uint64_t interval_msec = 0;
+    uint64_t next_sample_msec = 0;
+
+    static uint64_t _read_metric(Metric p_metric);
+    int _get_row_length(const Sample &p_sample) const;
+
+public:
+    // p_metric_flags has bit (1 << Metric) set for each metric to sample
+    void start(int p_capacity, uint32_t p_metric_flags, int p_interval_msec);
+    void stop();
+    bool is_running() const { return samples != nullptr; }
+
+    // Called once per frame on the main thread. Only samples when the interval has passed.
+    void sample();
+
+    // Writes a CSV header and the newest samples that fit, oldest first. Returns the number of bytes
+    // written (no null terminator). Does not allocate or lock, so it can run inside a crash handler.
+    // If the main thread is still running (the crash is on another thread), the newest row may be torn.
+    int write_csv(char *r_buffer, int p_size) const;
+    // Enough for the whole ring
+    int get_max_csv_size() const;
+
+    CrashpadTelemetry();
+    ~CrashpadTelemetry();
+};
+
+#endif // CRASHPAD_TELEMETRY_H
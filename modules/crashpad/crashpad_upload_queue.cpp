@@ -0,0 +1,208 @@
+/* crashpad_upload_queue.cpp */
+
+#include "crashpad_upload_queue.h"
+#include "core/os/os.h"
+
+// How often a sleeping worker checks if it has been asked to stop
+#define CRASHPAD_UPLOAD_QUEUE_POLL_USEC 100000
+
+
+void CrashpadUploadQueue::set_timeouts(int p_connect_timeout_msec, int p_total_timeout_msec)
+{
+    uploader.connect_timeout_msec = p_connect_timeout_msec;
+    uploader.total_timeout_msec = p_total_timeout_msec;
+}
+
+void CrashpadUploadQueue::set_max_bytes_per_second(int p_max_bytes_per_second)
+{
+    uploader.max_bytes_per_second = p_max_bytes_per_second;
+}
+
+void CrashpadUploadQueue::start(CrashpadReportIndex *p_index, const String &p_database_path, const Dictionary &p_attributes, UploadCallback p_callback, void *p_userdata)
+{
+    ERR_FAIL_NULL(p_index);
+    ERR_FAIL_NULL(p_callback);
+    stop();
+
+    index = p_index;
+    database_path = p_database_path;
+    // The game can change its attributes while we upload, so work on a copy
+    attributes = p_attributes.duplicate();
+    upload_callback = p_callback;
+    upload_userdata = p_userdata;
+
+    exit_requested.clear();
+    uploader.reset_cancel();
+    thread.start(_thread_func, this);
+}
+
+void CrashpadUploadQueue::request_stop()
+{
+    exit_requested.set();
+    uploader.cancel();
+}
+
+void CrashpadUploadQueue::stop()
+{
+    if (thread.is_started())
+    {
+        request_stop();
+        thread.wait_to_finish();
+    }
+}
+
+bool CrashpadUploadQueue::is_running() const
+{
+    return thread.is_started();
+}
+
+void CrashpadUploadQueue::_thread_func(void *p_userdata)
+{
+    CrashpadUploadQueue *self = (CrashpadUploadQueue *)p_userdata;
+    self->_run();
+}
+
+void CrashpadUploadQueue::_load_queue()
+{
+    queue.clear();
+
+    index->lock();
+    if (index->is_open() == false)
+    {
+        index->open(database_path);
+    }
+    index->reconcile();
+
+    Vector<String> report_ids = index->get_all_report_ids();
+    for (int i = 0; i < report_ids.size(); i++)
+    {
+        CrashpadReportIndex::Report report = index->get_report(report_ids[i]);
+        if (report.state == CrashpadReportIndex::REPORT_STATE_UPLOADED || report.attempts >= (uint32_t)max_attempts)
+        {
+            // Sent already, or given up on: nothing left to do but free the disk space
+            index->remove_report(report.id, true);
+            continue;
+        }
+
+        QueuedReport queued_report;
+        queued_report.id = report.id;
+        queued_report.path = report.path;
+        queued_report.attempts = report.attempts;
+        queue.push_back(queued_report);
+    }
+    index->save();
+    index->unlock();
+}
+
+bool CrashpadUploadQueue::_wait_until(uint64_t p_time_msec)
+{
+    while (OS::get_singleton()->get_ticks_msec() < p_time_msec)
+    {
+        if (exit_requested.is_set())
+        {
+            return false;
+        }
+        uint64_t remaining_usec = (p_time_msec - OS::get_singleton()->get_ticks_msec()) * 1000;
+        OS::get_singleton()->delay_usec(MIN(remaining_usec, (uint64_t)CRASHPAD_UPLOAD_QUEUE_POLL_USEC));
+    }
+    return exit_requested.is_set() == false;
+}
+
+uint64_t CrashpadUploadQueue::_get_rate_limit_time()
+{
+    if (max_requests_per_minute <= 0)
+    {
+        return 0;
+    }
+
+    // Forget requests older than a minute
+    uint64_t now = OS::get_singleton()->get_ticks_msec();
+    while (request_times_msec.size() > 0 && request_times_msec[0] + 60000 <= now)
+    {
+        request_times_msec.remove(0);
+    }
+
+    if (request_times_msec.size() < max_requests_per_minute)
+    {
+        return 0;
+    }
+    // The next request can go out once the oldest one in the window has left it
+    return request_times_msec[0] + 60000;
+}
+
+void CrashpadUploadQueue::_finish_report(const QueuedReport &p_report, Error p_result)
+{
+    index->lock();
+    if (index->has_report(p_report.id) == true)
+    {
+        index->increment_report_attempts(p_report.id);
+        if (p_result == OK || p_report.attempts >= (uint32_t)max_attempts)
+        {
+            index->remove_report(p_report.id, true);
+        }
+        else
+        {
+            index->set_report_state(p_report.id, CrashpadReportIndex::REPORT_STATE_FAILED);
+        }
+        index->save();
+    }
+    index->unlock();
+}
+
+void CrashpadUploadQueue::_run()
+{
+    _load_queue();
+
+    while (queue.size() > 0 && exit_requested.is_set() == false)
+    {
+        // Pick the report that is due first
+        int next_index = 0;
+        for (int i = 1; i < queue.size(); i++)
+        {
+            if (queue[i].next_attempt_msec < queue[next_index].next_attempt_msec)
+            {
+                next_index = i;
+            }
+        }
+        QueuedReport report = queue[next_index];
+
+        uint64_t start_time = MAX(report.next_attempt_msec, _get_rate_limit_time());
+        if (_wait_until(start_time) == false)
+        {
+            break;
+        }
+
+        request_times_msec.push_back(OS::get_singleton()->get_ticks_msec());
+        Error result = upload_callback(upload_userdata, uploader, report.path, attributes);
+        if (result == ERR_SKIP)
+        {
+            // Cancelled, so it does not count as an attempt
+            break;
+        }
+
+        report.attempts += 1;
+        _finish_report(report, result);
+
+        if (result == OK || report.attempts >= (uint32_t)max_attempts)
+        {
+            queue.remove(next_index);
+        }
+        else
+        {
+            // Exponential backoff: base, 2 * base, 4 * base... up to the maximum delay
+            uint64_t delay = (uint64_t)base_retry_delay_msec << MIN(report.attempts - 1, (uint32_t)16);
+            report.next_attempt_msec = OS::get_singleton()->get_ticks_msec() + MIN(delay, (uint64_t)max_retry_delay_msec);
+            queue.write[next_index] = report;
+        }
+    }
+    uploader.close();
+}
+
+CrashpadUploadQueue::CrashpadUploadQueue()
+{
+}
+
+CrashpadUploadQueue::~CrashpadUploadQueue()
+{
+    stop();
+}
@@ -0,0 +1,70 @@
+/* crashpad_upload_queue.h */
+
+#ifndef CRASHPAD_UPLOAD_QUEUE_H
+#define CRASHPAD_UPLOAD_QUEUE_H
+
+#include "core/dictionary.h"
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+#include "crashpad_report_index.h"
+#include "crashpad_uploader.h"
+
+// Uploads the reports left over from previous sessions on a worker thread.
+// Failed uploads are retried with exponential backoff until the attempt limit is reached,
+// and both the number of requests per minute and the upload bandwidth can be capped.
+class CrashpadUploadQueue {
+public:
+    // Returns OK once the report is done with, i.e. uploaded or dropped on purpose
+    typedef Error (*UploadCallback)(void *p_userdata, CrashpadUploader &p_uploader, const String &p_dump_path, const Dictionary &p_attributes);
+
+private:
+    struct QueuedReport {
+        String id;
+        String path;
+        uint32_t attempts = 0;
+        uint64_t next_attempt_msec = 0;
+    };
+
+    Thread thread;
+    SafeFlag exit_requested;
+    CrashpadUploader uploader;
+
+    CrashpadReportIndex *index = nullptr;
+    String database_path;
+    UploadCallback upload_callback = nullptr;
+    void *upload_userdata = nullptr;
+    Dictionary attributes;
+
+    Vector<QueuedReport> queue;
+    Vector<uint64_t> request_times_msec;
+
+    void _load_queue();
+    bool _wait_until(uint64_t p_time_msec);
+    uint64_t _get_rate_limit_time();
+    void _finish_report(const QueuedReport &p_report, Error p_result);
+    void _run();
+    static void _thread_func(void *p_userdata);
+
+public:
+    int max_attempts = 5;
+    // 0 means no limit
+    int max_requests_per_minute = 6;
+    int base_retry_delay_msec = 2000;
+    int max_retry_delay_msec = 300000;
+
+    void set_timeouts(int p_connect_timeout_msec, int p_total_timeout_msec);
+    void set_max_bytes_per_second(int p_max_bytes_per_second);
+
+    // Returns right away: opening the index and everything after it happens on the worker thread.
+    void start(CrashpadReportIndex *p_index, const String &p_database_path, const Dictionary &p_attributes, UploadCallback p_callback, void *p_userdata);
+    // Cancels the upload in progress and waits for the worker thread to exit.
+    void stop();
+    // Only asks the worker to stop, for use where joining a thread is not safe (e.g. while crashing).
+    void request_stop();
+    bool is_running() const;
+
+    CrashpadUploadQueue();
+    ~CrashpadUploadQueue();
+};
+
+#endif // CRASHPAD_UPLOAD_QUEUE_H
@@ -0,0 +1,885 @@
+/* crashpad_uploader.cpp */
+
+#include "crashpad_uploader.h"
+#include "core/io/ip.h"
+#include "core/math/math_funcs.h"
+#include "core/os/os.h"
+
+// Size of the chunks the body is streamed in
+#define CRASHPAD_UPLOAD_CHUNK_SIZE 16384
+// Limit on the size of a single response line, so a bad server cannot make us buffer forever
+#define CRASHPAD_UPLOAD_MAX_LINE_SIZE 8192
+
+
+// CrashpadMultipartBody
+// =====
+
+void CrashpadMultipartBody::_add_memory_segment(const String &p_text)
+{
+    Segment segment;
+    segment.data = p_text.utf8();
+    segments.push_back(segment);
+}
+
+void CrashpadMultipartBody::_close_current_file()
+{
+    if (current_file != nullptr)
+    {
+        current_file->close();
+        memdelete(current_file);
+        current_file = nullptr;
+    }
+}
+
+void CrashpadMultipartBody::add_field(const String &p_name, const String &p_value)
+{
+    ERR_FAIL_COND(finished);
+    String part = "--" + boundary + "\r\n";
+    part += "Content-Disposition: form-data; name=\"" + p_name + "\"\r\n\r\n";
+    part += p_value + "\r\n";
+    _add_memory_segment(part);
+}
+
+Error CrashpadMultipartBody::add_file(const String &p_name, const String &p_file_path, const String &p_content_type)
+{
+    FileAccess *file = FileAccess::open(p_file_path, FileAccess::READ);
+    if (file == nullptr)
+    {
+        return ERR_FILE_CANT_OPEN;
+    }
+    uint64_t file_length = file->get_len();
+    file->close();
+    memdelete(file);
+
+    return add_file_range(p_name, p_file_path, p_content_type, 0, file_length);
+}
+
+Error CrashpadMultipartBody::add_file_range(const String &p_name, const String &p_file_path, const String &p_content_type, uint64_t p_offset, uint64_t p_length)
+{
+    ERR_FAIL_COND_V(finished, ERR_ALREADY_IN_USE);
+
+    String part = "--" + boundary + "\r\n";
+    part += "Content-Disposition: form-data; name=\"" + p_name + "\"; filename=\"" + p_file_path.get_file() + "\"\r\n";
+    part += "Content-Type: " + p_content_type + "\r\n\r\n";
+    _add_memory_segment(part);
+
+    Segment segment;
+    segment.is_file = true;
+    segment.file_path = p_file_path;
+    segment.file_offset = p_offset;
+    segment.file_length = p_length;
+    segments.push_back(segment);
+
+    _add_memory_segment("\r\n");
+    return OK;
+}
+
+void CrashpadMultipartBody::add_file_data(const String &p_name, const String &p_file_name, const String &p_content_type, const CharString &p_data)
+{
+    ERR_FAIL_COND(finished);
+
+    String part = "--" + boundary + "\r\n";
+    part += "Content-Disposition: form-data; name=\"" + p_name + "\"; filename=\"" + p_file_name + "\"\r\n";
+    part += "Content-Type: " + p_content_type + "\r\n\r\n";
+    _add_memory_segment(part);
+
+    Segment segment;
+    segment.data = p_data;
+    segments.push_back(segment);
+
+    _add_memory_segment("\r\n");
+}
+
+void CrashpadMultipartBody::finish()
+{
+    if (finished == true)
+    {
+        return;
+    }
+    _add_memory_segment("--" + boundary + "--\r\n");
+    finished = true;
+}
+
+uint64_t CrashpadMultipartBody::get_size() const
+{
+    uint64_t size = 0;
+    for (int i = 0; i < segments.size(); i++)
+    {
+        size += segments[i].is_file ? segments[i].file_length : (uint64_t)segments[i].data.length();
+    }
+    return size;
+}
+
+String CrashpadMultipartBody::get_content_type() const
+{
+    return "multipart/form-data; boundary=" + boundary;
+}
+
+Error CrashpadMultipartBody::open()
+{
+    ERR_FAIL_COND_V(finished == false, ERR_UNCONFIGURED);
+    _close_current_file();
+    current_segment = 0;
+    current_position = 0;
+    return OK;
+}
+
+int CrashpadMultipartBody::read(uint8_t *r_buffer, int p_max_size)
+{
+    int total = 0;
+    while (total < p_max_size && current_segment < segments.size())
+    {
+        const Segment &segment = segments[current_segment];
+        uint64_t segment_length = segment.is_file ? segment.file_length : (uint64_t)segment.data.length();
+        uint64_t wanted = MIN(segment_length - current_position, (uint64_t)(p_max_size - total));
+
+        if (segment.is_file == false)
+        {
+            memcpy(r_buffer + total, segment.data.get_data() + current_position, wanted);
+        }
+        else if (wanted > 0)
+        {
+            if (current_file == nullptr)
+            {
+                current_file = FileAccess::open(segment.file_path, FileAccess::READ);
+                if (current_file == nullptr)
+                {
+                    return -1;
+                }
+                current_file->seek(segment.file_offset + current_position);
+            }
+            // The file got shorter since the size was taken, so the Content-Length would be wrong
+            if ((uint64_t)current_file->get_buffer(r_buffer + total, wanted) != wanted)
+            {
+                _close_current_file();
+                return -1;
+            }
+        }
+
+        total += wanted;
+        current_position += wanted;
+        if (current_position >= segment_length)
+        {
+            _close_current_file();
+            current_segment += 1;
+            current_position = 0;
+        }
+    }
+    return total;
+}
+
+void CrashpadMultipartBody::close()
+{
+    _close_current_file();
+}
+
+CrashpadMultipartBody::CrashpadMultipartBody()
+{
+    boundary = "GodotCrashpadBoundary" + String::num_uint64(OS::get_singleton()->get_ticks_usec(), 16) + String::num_uint64(Math::rand(), 16);
+}
+
+CrashpadMultipartBody::~CrashpadMultipartBody()
+{
+    _close_current_file();
+}
+// =====
+
+
+// CrashpadFileBody
+// =====
+
+Error CrashpadFileBody::set_file(const String &p_file_path, const String &p_content_type)
+{
+    close();
+    FileAccess *size_file = FileAccess::open(p_file_path, FileAccess::READ);
+    if (size_file == nullptr)
+    {
+        return ERR_FILE_CANT_OPEN;
+    }
+    file_length = size_file->get_len();
+    size_file->close();
+    memdelete(size_file);
+
+    file_path = p_file_path;
+    content_type = p_content_type;
+    return OK;
+}
+
+uint64_t CrashpadFileBody::get_size() const
+{
+    return file_length;
+}
+
+String CrashpadFileBody::get_content_type() const
+{
+    return content_type;
+}
+
+Error CrashpadFileBody::open()
+{
+    close();
+    file = FileAccess::open(file_path, FileAccess::READ);
+    return file == nullptr ? ERR_FILE_CANT_OPEN : OK;
+}
+
+int CrashpadFileBody::read(uint8_t *r_buffer, int p_max_size)
+{
+    ERR_FAIL_NULL_V(file, -1);
+    uint64_t remaining = file_length - file->get_position();
+    int wanted = MIN((uint64_t)p_max_size, remaining);
+    if (wanted == 0)
+    {
+        return 0;
+    }
+    return file->get_buffer(r_buffer, wanted) == wanted ? wanted : -1;
+}
+
+void CrashpadFileBody::close()
+{
+    if (file != nullptr)
+    {
+        file->close();
+        memdelete(file);
+        file = nullptr;
+    }
+}
+
+CrashpadFileBody::CrashpadFileBody()
+{
+}
+
+CrashpadFileBody::~CrashpadFileBody()
+{
+    close();
+}
+// =====
+
+
+// CrashpadMemoryBody
+// =====
+
+void CrashpadMemoryBody::set_data(const CharString &p_data, const String &p_content_type)
+{
+    data = p_data;
+    content_type = p_content_type;
+    position = 0;
+}
+
+uint64_t CrashpadMemoryBody::get_size() const
+{
+    return data.length();
+}
+
+String CrashpadMemoryBody::get_content_type() const
+{
+    return content_type;
+}
+
+Error CrashpadMemoryBody::open()
+{
+    position = 0;
+    return OK;
+}
+
+int CrashpadMemoryBody::read(uint8_t *r_buffer, int p_max_size)
+{
+    int wanted = MIN(p_max_size, data.length() - position);
+    if (wanted <= 0)
+    {
+        return 0;
+    }
+    memcpy(r_buffer, data.get_data() + position, wanted);
+    position += wanted;
+    return wanted;
+}
+
+void CrashpadMemoryBody::close()
+{
+}
+
+CrashpadMemoryBody::CrashpadMemoryBody()
+{
+}
+// =====
+
+
+// CrashpadUploader
+// =====
+
+Error CrashpadUploader::_parse_url(const String &p_url, String &r_host, int &r_port, bool &r_use_ssl, String &r_path)
+{
+    String url = p_url.strip_edges();
+    if (url.begins_with("https://"))
+    {
+        r_use_ssl = true;
+        r_port = 443;
+        url = url.substr(8, url.length() - 8);
+    }
+    else if (url.begins_with("http://"))
+    {
+        r_use_ssl = false;
+        r_port = 80;
+        url = url.substr(7, url.length() - 7);
+    }
+    else
+    {
+        return ERR_INVALID_PARAMETER;
+    }
+
+    int path_start = url.find("/");
+    if (path_start == -1)
+    {
+        r_host = url;
+        r_path = "/";
+    }
+    else
+    {
+        r_host = url.substr(0, path_start);
+        r_path = url.substr(path_start, url.length() - path_start);
+    }
+
+    int port_start = r_host.find_last(":");
+    if (port_start != -1)
+    {
+        r_port = r_host.substr(port_start + 1, r_host.length() - port_start - 1).to_int();
+        r_host = r_host.substr(0, port_start);
+    }
+
+    if (r_host.empty() == true || r_port <= 0 || r_port > 65535)
+    {
+        return ERR_INVALID_PARAMETER;
+    }
+    return OK;
+}
+
+Error CrashpadUploader::_resolve(const String &p_host, uint64_t p_deadline, IP_Address &r_address)
+{
+    if (p_host.is_valid_ip_address() == true)
+    {
+        r_address = IP_Address(p_host);
+        return OK;
+    }
+
+    // Resolved on the resolver thread, so a slow DNS server cannot hold us past the deadline
+    IP::ResolverID resolver_id = IP::get_singleton()->resolve_hostname_queue_item(p_host);
+    if (resolver_id == IP::RESOLVER_INVALID_ID)
+    {
+        return ERR_CANT_RESOLVE;
+    }
+    Error error = OK;
+    while (IP::get_singleton()->get_resolve_item_status(resolver_id) == IP::RESOLVER_STATUS_WAITING)
+    {
+        error = _wait(p_deadline);
+        if (error != OK)
+        {
+            break;
+        }
+    }
+    if (error == OK && IP::get_singleton()->get_resolve_item_status(resolver_id) == IP::RESOLVER_STATUS_DONE)
+    {
+        r_address = IP::get_singleton()->get_resolve_item_address(resolver_id);
+    }
+    IP::get_singleton()->erase_resolve_item(resolver_id);
+    if (error != OK)
+    {
+        return error;
+    }
+    return r_address.is_valid() == true ? OK : ERR_CANT_RESOLVE;
+}
+
+Error CrashpadUploader::_connect(const String &p_host, int p_port, bool p_use_ssl, uint64_t p_deadline)
+{
+    close();
+
+    uint64_t connect_deadline = MIN(p_deadline, OS::get_singleton()->get_ticks_msec() + connect_timeout_msec);
+    IP_Address address;
+    Error error = _resolve(p_host, connect_deadline, address);
+    if (error != OK)
+    {
+        return error;
+    }
+
+    tcp.instance();
+    error = tcp->connect_to_host(address, p_port);
+    if (error != OK)
+    {
+        close();
+        return error;
+    }
+
+    while (tcp->get_status() == StreamPeerTCP::STATUS_CONNECTING)
+    {
+        error = _wait(connect_deadline);
+        if (error != OK)
+        {
+            close();
+            return error;
+        }
+    }
+    if (tcp->get_status() != StreamPeerTCP::STATUS_CONNECTED)
+    {
+        close();
+        return ERR_CANT_CONNECT;
+    }
+    tcp->set_no_delay(true);
+
+    if (p_use_ssl == true)
+    {
+        ssl = Ref<StreamPeerSSL>(StreamPeerSSL::create());
+        if (ssl.is_null())
+        {
+            close();
+            return ERR_UNAVAILABLE;
+        }
+        // The blocking handshake would wait on a stalled server forever, so it is stepped here instead
+        ssl->set_blocking_handshake_enabled(false);
+        error = ssl->connect_to_stream(tcp, true, p_host, trusted_certificate);
+        if (error != OK)
+        {
+            close();
+            return error;
+        }
+        while (ssl->get_status() == StreamPeerSSL::STATUS_HANDSHAKING)
+        {
+            error = _wait(connect_deadline);
+            if (error != OK)
+            {
+                close();
+                return error;
+            }
+            ssl->poll();
+        }
+        // Also STATUS_ERROR_HOSTNAME_MISMATCH and certificate errors
+        if (ssl->get_status() != StreamPeerSSL::STATUS_CONNECTED)
+        {
+            close();
+            return ERR_CANT_CONNECT;
+        }
+        connection = ssl;
+    }
+    else
+    {
+        connection = tcp;
+    }
+
+    connected_host = p_host;
+    connected_port = p_port;
+    connected_use_ssl = p_use_ssl;
+    response_buffer_position = 0;
+    response_buffer_size = 0;
+    return OK;
+}
+
+bool CrashpadUploader::_is_connected_to(const String &p_host, int p_port, bool p_use_ssl)
+{
+    if (connection.is_null() || tcp->get_status() != StreamPeerTCP::STATUS_CONNECTED)
+    {
+        return false;
+    }
+    if (p_use_ssl == true && ssl->get_status() != StreamPeerSSL::STATUS_CONNECTED)
+    {
+        return false;
+    }
+    return connected_host == p_host && connected_port == p_port && connected_use_ssl == p_use_ssl;
+}
+
+Error CrashpadUploader::_wait(uint64_t p_deadline)
+{
+    if (cancelled.is_set())
+    {
+        return ERR_SKIP;
+    }
+    if (OS::get_singleton()->get_ticks_msec() > p_deadline)
+    {
+        return ERR_TIMEOUT;
+    }
+    OS::get_singleton()->delay_usec(1000);
+    return OK;
+}
+
+Error CrashpadUploader::_write_all(const uint8_t *p_data, int p_size, uint64_t p_deadline)
+{
+    while (p_size > 0)
+    {
+        int sent = 0;
+        Error error = connection->put_partial_data(p_data, p_size, sent);
+        if (error != OK)
+        {
+            return error;
+        }
+        if (sent == 0)
+        {
+            error = _wait(p_deadline);
+            if (error != OK)
+            {
+                return error;
+            }
+        }
+        p_data += sent;
+        p_size -= sent;
+    }
+    return OK;
+}
+
+Error CrashpadUploader::_read_some(uint8_t *r_buffer, int p_max_size, int &r_received, uint64_t p_deadline)
+{
+    r_received = 0;
+    while (r_received == 0)
+    {
+        if (connected_use_ssl == true)
+        {
+            ssl->poll();
+        }
+        Error error = connection->get_partial_data(r_buffer, p_max_size, r_received);
+        if (error != OK)
+        {
+            return error;
+        }
+        if (r_received == 0)
+        {
+            error = _wait(p_deadline);
+            if (error != OK)
+            {
+                return error;
+            }
+        }
+    }
+    return OK;
+}
+
+Error CrashpadUploader::_read_byte(uint8_t &r_byte, uint64_t p_deadline)
+{
+    if (response_buffer_position >= response_buffer_size)
+    {
+        response_buffer_position = 0;
+        Error error = _read_some(response_buffer, sizeof(response_buffer), response_buffer_size, p_deadline);
+        if (error != OK)
+        {
+            response_buffer_size = 0;
+            return error;
+        }
+    }
+    r_byte = response_buffer[response_buffer_position];
+    response_buffer_position += 1;
+    return OK;
+}
+
+Error CrashpadUploader::_read_line(String &r_line, uint64_t p_deadline)
+{
+    CharString line;
+    uint8_t byte = 0;
+    while (true)
+    {
+        Error error = _read_byte(byte, p_deadline);
+        if (error != OK)
+        {
+            return error;
+        }
+        if (byte == '\n')
+        {
+            break;
+        }
+        if (byte != '\r')
+        {
+            if (line.length() >= CRASHPAD_UPLOAD_MAX_LINE_SIZE)
+            {
+                return ERR_OUT_OF_MEMORY;
+            }
+            line += (char)byte;
+        }
+    }
+    r_line.parse_utf8(line.get_data(), line.length());
+    return OK;
+}
+
+Error CrashpadUploader::_skip_bytes(uint64_t p_count, uint64_t p_deadline)
+{
+    while (p_count > 0)
+    {
+        if (response_buffer_position >= response_buffer_size)
+        {
+            response_buffer_position = 0;
+            Error error = _read_some(response_buffer, sizeof(response_buffer), response_buffer_size, p_deadline);
+            if (error != OK)
+            {
+                response_buffer_size = 0;
+                return error;
+            }
+        }
+        int skipped = MIN((uint64_t)(response_buffer_size - response_buffer_position), p_count);
+        response_buffer_position += skipped;
+        p_count -= skipped;
+    }
+    return OK;
+}
+
+Error CrashpadUploader::_send_request(const String &p_host, const String &p_path, CrashpadUploadBody *p_body, const Vector<String> &p_headers, uint64_t p_deadline)
+{
+    String request = "POST " + p_path + " HTTP/1.1\r\n";
+    request += "Host: " + p_host + "\r\n";
+    request += "User-Agent: GodotCrashpad\r\n";
+    request += "Connection: keep-alive\r\n";
+    request += "Content-Type: " + p_body->get_content_type() + "\r\n";
+    request += "Content-Length: " + String::num_uint64(p_body->get_size()) + "\r\n";
+    for (int i = 0; i < p_headers.size(); i++)
+    {
+        request += p_headers[i] + "\r\n";
+    }
+    request += "\r\n";
+
+    CharString request_utf8 = request.utf8();
+    Error error = _write_all((const uint8_t *)request_utf8.get_data(), request_utf8.length(), p_deadline);
+    if (error != OK)
+    {
+        return error;
+    }
+
+    error = p_body->open();
+    if (error != OK)
+    {
+        return error;
+    }
+
+    uint8_t chunk[CRASHPAD_UPLOAD_CHUNK_SIZE];
+    uint64_t sent = 0;
+    uint64_t send_start_msec = OS::get_singleton()->get_ticks_msec();
+    while (true)
+    {
+        int read = p_body->read(chunk, CRASHPAD_UPLOAD_CHUNK_SIZE);
+        if (read < 0)
+        {
+            error = ERR_FILE_CANT_READ;
+            break;
+        }
+        if (read == 0)
+        {
+            break;
+        }
+        error = _write_all(chunk, read, p_deadline);
+        if (error != OK)
+        {
+            break;
+        }
+        sent += read;
+
+        // Bandwidth cap: hold back until the average rate is under the limit again
+        if (max_bytes_per_second > 0)
+        {
+            uint64_t earliest_msec = send_start_msec + sent * 1000 / max_bytes_per_second;
+            while (error == OK && OS::get_singleton()->get_ticks_msec() < earliest_msec)
+            {
+                error = _wait(p_deadline);
+            }
+            if (error != OK)
+            {
+                break;
+            }
+        }
+    }
+    p_body->close();
+
+    if (error == OK && sent != p_body->get_size())
+    {
+        error = ERR_FILE_CORRUPT;
+    }
+    return error;
+}
+
+Error CrashpadUploader::_read_response(int &r_response_code, bool &r_keep_alive, uint64_t p_deadline)
+{
+    String status_line;
+    Error error = _read_line(status_line, p_deadline);
+    if (error != OK)
+    {
+        return error;
+    }
+
+    // For example: "HTTP/1.1 200 OK"
+    Vector<String> status_parts = status_line.split(" ");
+    if (status_parts.size() < 2 || status_parts[0].begins_with("HTTP/") == false)
+    {
+        return ERR_INVALID_DATA;
+    }
+    r_response_code = status_parts[1].to_int();
+    r_keep_alive = status_parts[0] == "HTTP/1.1";
+
+    int64_t content_length = -1;
+    bool chunked = false;
+    while (true)
+    {
+        String header_line;
+        error = _read_line(header_line, p_deadline);
+        if (error != OK)
+        {
+            return error;
+        }
+        if (header_line.empty())
+        {
+            break;
+        }
+
+        int separator = header_line.find(":");
+        if (separator == -1)
+        {
+            continue;
+        }
+        String header_name = header_line.substr(0, separator).strip_edges().to_lower();
+        String header_value = header_line.substr(separator + 1, header_line.length() - separator - 1).strip_edges().to_lower();
+
+        if (header_name == "content-length")
+        {
+            content_length = header_value.to_int64();
+        }
+        else if (header_name == "transfer-encoding")
+        {
+            chunked = header_value.find("chunked") != -1;
+        }
+        else if (header_name == "connection")
+        {
+            r_keep_alive = header_value.find("close") == -1 && (r_keep_alive || header_value.find("keep-alive") != -1);
+        }
+    }
+
+    // The response body is not needed, but it has to be consumed so the connection can be reused
+    if (chunked == true)
+    {
+        while (true)
+        {
+            String chunk_size_line;
+            error = _read_line(chunk_size_line, p_deadline);
+            if (error != OK)
+            {
+                return error;
+            }
+            int64_t chunk_size = chunk_size_line.get_slice(";", 0).strip_edges().hex_to_int64(false);
+            if (chunk_size <= 0)
+            {
+                break;
+            }
+            // Chunk data plus its trailing CRLF
+            error = _skip_bytes(chunk_size + 2, p_deadline);
+            if (error != OK)
+            {
+                return error;
+            }
+        }
+        // Trailers, ending with an empty line
+        String trailer_line = "-";
+        while (trailer_line.empty() == false)
+        {
+            error = _read_line(trailer_line, p_deadline);
+            if (error != OK)
+            {
+                return error;
+            }
+        }
+    }
+    else if (content_length >= 0)
+    {
+        error = _skip_bytes(content_length, p_deadline);
+        if (error != OK)
+        {
+            return error;
+        }
+    }
+    else
+    {
+        // No length given, so the body ends when the server closes the connection
+        r_keep_alive = false;
+    }
+    return OK;
+}
+
+Error CrashpadUploader::post(const String &p_url, CrashpadUploadBody *p_body, const Vector<String> &p_headers, int &r_response_code)
+{
+    ERR_FAIL_NULL_V(p_body, ERR_INVALID_PARAMETER);
+    r_response_code = 0;
+
+    String host;
+    String path;
+    int port = 0;
+    bool use_ssl = false;
+    Error error = _parse_url(p_url, host, port, use_ssl, path);
+    if (error != OK)
+    {
+        return error;
+    }
+
+    uint64_t deadline = OS::get_singleton()->get_ticks_msec() + total_timeout_msec;
+    bool keep_alive = false;
+
+    bool reused_connection = _is_connected_to(host, port, use_ssl);
+    if (reused_connection == false)
+    {
+        error = _connect(host, port, use_ssl, deadline);
+    }
+    if (error == OK)
+    {
+        error = _send_request(host, path, p_body, p_headers, deadline);
+    }
+    if (error == OK)
+    {
+        error = _read_response(r_response_code, keep_alive, deadline);
+    }
+
+    // The server may have closed an idle kept-alive connection, so retry once on a fresh one
+    bool can_retry = error != ERR_FILE_CANT_READ && error != ERR_FILE_CORRUPT && error != ERR_SKIP && error != ERR_TIMEOUT;
+    if (error != OK && reused_connection == true && can_retry == true)
+    {
+        error = _connect(host, port, use_ssl, deadline);
+        if (error == OK)
+        {
+            error = _send_request(host, path, p_body, p_headers, deadline);
+        }
+        if (error == OK)
+        {
+            error = _read_response(r_response_code, keep_alive, deadline);
+        }
+    }
+
+    if (error != OK || keep_alive == false)
+    {
+        close();
+    }
+    return error;
+}
+
+void CrashpadUploader::cancel()
+{
+    cancelled.set();
+}
+
+void CrashpadUploader::reset_cancel()
+{
+    cancelled.clear();
+}
+
+void CrashpadUploader::close()
+{
+    if (ssl.is_valid())
+    {
+        ssl->disconnect_from_stream();
+    }
+    if (tcp.is_valid())
+    {
+        tcp->disconnect_from_host();
+    }
+    ssl.unref();
+    tcp.unref();
+    connection.unref();
+    connected_host = "";
+    connected_port = 0;
+    connected_use_ssl = false;
+    response_buffer_position = 0;
+    response_buffer_size = 0;
+}
+
+CrashpadUploader::CrashpadUploader()
+{
+}
+
+CrashpadUploader::~CrashpadUploader()
+{
+    close();
+}
+// =====
@@ -0,0 +1,159 @@
+/* crashpad_uploader.h */
+
+#ifndef CRASHPAD_UPLOADER_H
+#define CRASHPAD_UPLOADER_H
+
+#include "core/crypto/crypto.h"
+#include "core/io/ip_address.h"
+#include "core/io/stream_peer_ssl.h"
+#include "core/io/stream_peer_tcp.h"
+#include "core/os/file_access.h"
+#include "core/safe_refcount.h"
+#include "core/ustring.h"
+#include "core/vector.h"
+
+// The body of an upload request. Bodies are read in small chunks so that
+// minidumps and log files are streamed from disk instead of loaded into memory.
+class CrashpadUploadBody {
+public:
+    virtual uint64_t get_size() const = 0;
+    virtual String get_content_type() const = 0;
+
+    // Rewinds the body to the start. Called before every send attempt.
+    virtual Error open() = 0;
+    // Returns the number of bytes read, 0 at the end of the body, or -1 on error.
+    virtual int read(uint8_t *r_buffer, int p_max_size) = 0;
+    virtual void close() = 0;
+
+    virtual ~CrashpadUploadBody() {}
+};
+
+// A multipart/form-data body made of text fields and file parts.
+class CrashpadMultipartBody : public CrashpadUploadBody {
+    struct Segment {
+        CharString data;
+        String file_path;
+        uint64_t file_offset = 0;
+        uint64_t file_length = 0;
+        bool is_file = false;
+    };
+
+    String boundary;
+    Vector<Segment> segments;
+    bool finished = false;
+
+    int current_segment = 0;
+    uint64_t current_position = 0;
+    FileAccess *current_file = nullptr;
+
+    void _add_memory_segment(const String &p_text);
+    void _close_current_file();
+
+public:
+    void add_field(const String &p_name, const String &p_value);
+    Error add_file(const String &p_name, const String &p_file_path, const String &p_content_type);
+    // Adds only the given byte range of a file, used for partial attachments.
+    Error add_file_range(const String &p_name, const String &p_file_path, const String &p_content_type, uint64_t p_offset, uint64_t p_length);
+    // Adds a file part whose content is already in memory.
+    void add_file_data(const String &p_name, const String &p_file_name, const String &p_content_type, const CharString &p_data);
+    void finish();
+
+    virtual uint64_t get_size() const;
+    virtual String get_content_type() const;
+    virtual Error open();
+    virtual int read(uint8_t *r_buffer, int p_max_size);
+    virtual void close();
+
+    CrashpadMultipartBody();
+    ~CrashpadMultipartBody();
+};
+
+// A body read straight from a file, e.g. one that was compressed ahead of the upload.
+class CrashpadFileBody : public CrashpadUploadBody {
+    String file_path;
+    String content_type;
+    uint64_t file_length = 0;
+    FileAccess *file = nullptr;
+
+public:
+    Error set_file(const String &p_file_path, const String &p_content_type);
+
+    virtual uint64_t get_size() const;
+    virtual String get_content_type() const;
+    virtual Error open();
+    virtual int read(uint8_t *r_buffer, int p_max_size);
+    virtual void close();
+
+    CrashpadFileBody();
+    ~CrashpadFileBody();
+};
+
+// A body that is already in memory, e.g. a small JSON record.
+class CrashpadMemoryBody : public CrashpadUploadBody {
+    CharString data;
+    String content_type;
+    int position = 0;
+
+public:
+    void set_data(const CharString &p_data, const String &p_content_type);
+
+    virtual uint64_t get_size() const;
+    virtual String get_content_type() const;
+    virtual Error open();
+    virtual int read(uint8_t *r_buffer, int p_max_size);
+    virtual void close();
+
+    CrashpadMemoryBody();
+};
+
+// A small blocking HTTP/1.1 client used to upload crash reports.
+// The connection is kept alive between uploads to the same host, so a burst of
+// dumps costs a single connection. Both connect and total timeouts are enforced,
+// on every step: resolving the host, the TCP connection, the TLS handshake and the request.
+class CrashpadUploader {
+    Ref<StreamPeerTCP> tcp;
+    Ref<StreamPeerSSL> ssl;
+    Ref<StreamPeer> connection;
+    String connected_host;
+    int connected_port = 0;
+    bool connected_use_ssl = false;
+
+    uint8_t response_buffer[4096];
+    int response_buffer_position = 0;
+    int response_buffer_size = 0;
+
+    SafeFlag cancelled;
+
+    Error _parse_url(const String &p_url, String &r_host, int &r_port, bool &r_use_ssl, String &r_path);
+    Error _resolve(const String &p_host, uint64_t p_deadline, IP_Address &r_address);
+    Error _connect(const String &p_host, int p_port, bool p_use_ssl, uint64_t p_deadline);
+    bool _is_connected_to(const String &p_host, int p_port, bool p_use_ssl);
+    Error _wait(uint64_t p_deadline);
+    Error _write_all(const uint8_t *p_data, int p_size, uint64_t p_deadline);
+    Error _read_some(uint8_t *r_buffer, int p_max_size, int &r_received, uint64_t p_deadline);
+    Error _read_byte(uint8_t &r_byte, uint64_t p_deadline);
+    Error _read_line(String &r_line, uint64_t p_deadline);
+    Error _skip_bytes(uint64_t p_count, uint64_t p_deadline);
+    Error _send_request(const String &p_host, const String &p_path, CrashpadUploadBody *p_body, const Vector<String> &p_headers, uint64_t p_deadline);
+    Error _read_response(int &r_response_code, bool &r_keep_alive, uint64_t p_deadline);
+
+public:
+    int connect_timeout_msec = 5000;
+    int total_timeout_msec = 30000;
+    // 0 means no limit
+    int max_bytes_per_second = 0;
+    // If set, https servers must have this certificate instead of one signed by the usual CAs (e.g. a test server)
+    Ref<X509Certificate> trusted_certificate;
+
+    Error post(const String &p_url, CrashpadUploadBody *p_body, const Vector<String> &p_headers, int &r_response_code);
+    void close();
+
+    // Makes the upload in progress (and any later ones) fail with ERR_SKIP. Safe to call from any thread.
+    void cancel();
+    void reset_cancel();
+
+    CrashpadUploader();
+    ~CrashpadUploader();
+};
+
+#endif // CRASHPAD_UPLOADER_H
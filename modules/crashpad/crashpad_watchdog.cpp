@@ -0,0 +1,80 @@
+/* crashpad_watchdog.cpp */
+
+#include "crashpad_watchdog.h"
+#include "core/os/os.h"
+
+
+void CrashpadWatchdog::start(HangCallback p_callback, void *p_userdata)
+{
+    ERR_FAIL_NULL(p_callback);
+    stop();
+
+    hang_callback = p_callback;
+    hang_userdata = p_userdata;
+    exit_requested.clear();
+    thread.start(_thread_func, this);
+}
+
+void CrashpadWatchdog::stop()
+{
+    if (thread.is_started())
+    {
+        exit_requested.set();
+        thread.wait_to_finish();
+    }
+}
+
+void CrashpadWatchdog::request_stop()
+{
+    exit_requested.set();
+}
+
+bool CrashpadWatchdog::is_running() const
+{
+    return thread.is_started();
+}
+
+void CrashpadWatchdog::_thread_func(void *p_userdata)
+{
+    ((CrashpadWatchdog *)p_userdata)->_run();
+}
+
+void CrashpadWatchdog::_run()
+{
+    // Checking a few times per threshold keeps the detection delay well under the threshold itself
+    uint64_t poll_usec = (uint64_t)CLAMP(threshold_msec / 4, 10, 250) * 1000;
+    uint64_t last_heartbeat = heartbeat.load(std::memory_order_relaxed);
+    uint64_t last_change_msec = OS::get_singleton()->get_ticks_msec();
+    bool reported = false;
+
+    while (exit_requested.is_set() == false)
+    {
+        OS::get_singleton()->delay_usec(poll_usec);
+
+        uint64_t now = OS::get_singleton()->get_ticks_msec();
+        uint64_t current_heartbeat = heartbeat.load(std::memory_order_relaxed);
+        if (current_heartbeat != last_heartbeat)
+        {
+            last_heartbeat = current_heartbeat;
+            last_change_msec = now;
+            reported = false;
+            continue;
+        }
+
+        if (reported == false && now - last_change_msec >= (uint64_t)threshold_msec)
+        {
+            hang_callback(hang_userdata, now - last_change_msec);
+            reported = true;
+        }
+    }
+}
+
+CrashpadWatchdog::CrashpadWatchdog() :
+        heartbeat(0)
+{
+}
+
+CrashpadWatchdog::~CrashpadWatchdog()
+{
+    stop();
+}
@@ -0,0 +1,51 @@
+/* crashpad_watchdog.h */
+
+#ifndef CRASHPAD_WATCHDOG_H
+#define CRASHPAD_WATCHDOG_H
+
+#include "core/os/thread.h"
+#include "core/safe_refcount.h"
+
+#include <atomic>
+
+// Detects when the main loop stops ticking, i.e. the game froze.
+// The main thread only stores a frame counter each frame; a monitor thread checks it a few times
+// per threshold and calls the hang callback once when it has not moved for the threshold. It waits
+// for the counter to move again before another hang can be reported.
+class CrashpadWatchdog {
+public:
+    typedef void (*HangCallback)(void *p_userdata, uint64_t p_hang_msec);
+
+private:
+    std::atomic<uint64_t> heartbeat;
+    uint64_t frame = 0;
+
+    Thread thread;
+    SafeFlag exit_requested;
+    HangCallback hang_callback = nullptr;
+    void *hang_userdata = nullptr;
+
+    void _run();
+    static void _thread_func(void *p_userdata);
+
+public:
+    int threshold_msec = 5000;
+
+    // Called once per frame on the main thread: a single relaxed store, no locks and no system calls.
+    _FORCE_INLINE_ void tick()
+    {
+        heartbeat.store(++frame, std::memory_order_relaxed);
+    }
+
+    void start(HangCallback p_callback, void *p_userdata);
+    // Waits for the monitor thread, which may be busy reporting a hang.
+    void stop();
+    // Only asks the monitor thread to stop, for use where joining a thread is not safe (e.g. while crashing).
+    void request_stop();
+    bool is_running() const;
+
+    CrashpadWatchdog();
+    ~CrashpadWatchdog();
+};
+
+#endif // CRASHPAD_WATCHDOG_H
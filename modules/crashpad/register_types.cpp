@@ -1,12 +1,20 @@
 #include "register_types.h"
 
 #include "core/class_db.h"
+#include "core/project_settings.h"
 #include "crashpad.h"
 
 void register_crashpad_types() {
     ClassDB::register_class<Crashpad>();
+
+    // Script call stacks in crash reports. Has to be decided here, before the script languages
+    // are registered, so it is a project setting and not a property of the node.
+    if (GLOBAL_DEF("crashpad/script_call_stack", false))
+    {
+        CrashpadScriptStack::install_debugger();
+    }
 }
 
 void unregister_crashpad_types() {
-   // Nothing to do here in this example.
-}
\ No newline at end of file
+    CrashpadScriptStack::uninstall_debugger();
+}
@@ -0,0 +1,281 @@
+#!/usr/bin/env python
+"""Breakpad symbol files for crash report symbolication.
+
+Runs Breakpad's dump_syms on each binary, in parallel, and writes the output in the
+standard symbol store layout: <store>/<module>/<debug id>/<module>.sym
+
+The debug id is read straight from the binary headers (ELF build id, PE CodeView record,
+Mach-O LC_UUID), so a binary whose symbols are already in the store is skipped without
+running dump_syms. Binaries without an id are remembered by size and modification time.
+
+Used by the "crashpad_symbols" SCons target, or from the command line:
+    python crashpad_symbols.py --store bin/symbols bin/godot.x11.opt.64
+"""
+
+import argparse
+import json
+import mmap
+import os
+import shutil
+import struct
+import subprocess
+import sys
+import tempfile
+from concurrent.futures import ThreadPoolExecutor
+
+CACHE_FILE_NAME = ".crashpad_symbols_cache.json"
+CACHE_VERSION = 1
+
+
+# Debug ids, the same way Breakpad computes them
+
+
+def _elf_debug_id(data):
+    if data[4] not in (1, 2) or data[5] not in (1, 2):
+        return None
+    is_64 = data[4] == 2
+    endian = "<" if data[5] == 1 else ">"
+
+    if is_64:
+        section_offset, = struct.unpack_from(endian + "Q", data, 0x28)
+        entry_size, count = struct.unpack_from(endian + "HH", data, 0x3A)
+    else:
+        section_offset, = struct.unpack_from(endian + "I", data, 0x20)
+        entry_size, count = struct.unpack_from(endian + "HH", data, 0x2E)
+
+    for i in range(count):
+        header = section_offset + i * entry_size
+        section_type, = struct.unpack_from(endian + "I", data, header + 4)
+        if section_type != 7:  # SHT_NOTE
+            continue
+        if is_64:
+            offset, size = struct.unpack_from(endian + "QQ", data, header + 0x18)
+        else:
+            offset, size = struct.unpack_from(endian + "II", data, header + 0x10)
+
+        position = offset
+        while position + 12 <= offset + size:
+            name_size, desc_size, note_type = struct.unpack_from(endian + "III", data, position)
+            name_start = position + 12
+            desc_start = name_start + ((name_size + 3) & ~3)
+            if note_type == 3 and data[name_start : name_start + name_size] == b"GNU\0":  # NT_GNU_BUILD_ID
+                build_id = bytes(data[desc_start : desc_start + desc_size])
+                # The first 16 bytes, as a GUID with little endian fields, and an age of 0
+                guid = build_id[:16].ljust(16, b"\0")
+                guid = guid[3::-1] + guid[5:3:-1] + guid[7:5:-1] + guid[8:]
+                return guid.hex().upper() + "0", None
+            position = desc_start + ((desc_size + 3) & ~3)
+    # Breakpad hashes the text section instead, let dump_syms work it out
+    return None
+
+
+def _pe_debug_id(data):
+    pe_offset, = struct.unpack_from("<I", data, 0x3C)
+    if data[pe_offset : pe_offset + 4] != b"PE\0\0":
+        return None
+    coff = pe_offset + 4
+    section_count, = struct.unpack_from("<H", data, coff + 2)
+    optional_size, = struct.unpack_from("<H", data, coff + 16)
+    optional = coff + 20
+    magic, = struct.unpack_from("<H", data, optional)
+    directories = optional + (112 if magic == 0x20B else 96)
+    debug_rva, debug_size = struct.unpack_from("<II", data, directories + 6 * 8)
+    if debug_rva == 0:
+        return None
+
+    # The debug directory is given as an address in memory, find where it is in the file
+    sections = optional + optional_size
+    debug_offset = None
+    for i in range(section_count):
+        header = sections + i * 40
+        virtual_size, virtual_address, raw_size, raw_offset = struct.unpack_from("<IIII", data, header + 8)
+        if virtual_address <= debug_rva < virtual_address + max(virtual_size, raw_size):
+            debug_offset = debug_rva - virtual_address + raw_offset
+            break
+    if debug_offset is None:
+        return None
+
+    for entry in range(debug_offset, debug_offset + debug_size, 28):
+        entry_type, = struct.unpack_from("<I", data, entry + 12)
+        record_offset, = struct.unpack_from("<I", data, entry + 24)
+        if entry_type != 2 or data[record_offset : record_offset + 4] != b"RSDS":  # IMAGE_DEBUG_TYPE_CODEVIEW
+            continue
+        data1, data2, data3 = struct.unpack_from("<IHH", data, record_offset + 4)
+        data4 = bytes(data[record_offset + 12 : record_offset + 20])
+        age, = struct.unpack_from("<I", data, record_offset + 20)
+        pdb_end = data.find(b"\0", record_offset + 24)
+        pdb_path = bytes(data[record_offset + 24 : pdb_end]).decode("utf-8", "replace")
+        debug_id = "%08X%04X%04X%s%x" % (data1, data2, data3, data4.hex().upper(), age)
+        # Symbols of Windows binaries are filed under the name of their PDB
+        return debug_id, pdb_path.replace("\\", "/").split("/")[-1]
+    return None
+
+
+def _macho_debug_id(data):
+    magic, = struct.unpack_from("<I", data, 0)
+    if magic not in (0xFEEDFACE, 0xFEEDFACF):
+        # Universal binaries get one symbol file per architecture, let dump_syms sort them out
+        return None
+    command_count, = struct.unpack_from("<I", data, 16)
+    position = 32 if magic == 0xFEEDFACF else 28
+    for i in range(command_count):
+        command, command_size = struct.unpack_from("<II", data, position)
+        if command == 0x1B:  # LC_UUID
+            return bytes(data[position + 8 : position + 24]).hex().upper() + "0", None
+        position += command_size
+    return None
+
+
+def read_debug_id(path):
+    """Returns (debug id, module name) without running dump_syms, or None if it cannot be read."""
+    try:
+        with open(path, "rb") as f:
+            data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+    except (OSError, ValueError):
+        return None
+    try:
+        result = None
+        if data[:4] == b"\x7fELF":
+            result = _elf_debug_id(data)
+        elif data[:2] == b"MZ":
+            result = _pe_debug_id(data)
+        elif data[:4] in (b"\xce\xfa\xed\xfe", b"\xcf\xfa\xed\xfe"):
+            result = _macho_debug_id(data)
+    except (struct.error, IndexError, ValueError):
+        result = None
+    finally:
+        data.close()
+
+    if result is None:
+        return None
+    debug_id, module_name = result
+    return debug_id, module_name or os.path.basename(path)
+
+
+def get_symbol_path(store, module_name, debug_id):
+    base_name = module_name[:-4] if module_name.lower().endswith(".pdb") else module_name
+    return os.path.join(store, module_name, debug_id, base_name + ".sym")
+
+
+# Dumping
+
+
+def find_dump_syms(path=""):
+    if path:
+        return path if os.path.isfile(path) else None
+    root = os.path.abspath(os.path.join(os.path.dirname(__file__), "..", "..", ".."))
+    for candidate in [
+        "thirdparty/breakpad/src/tools/linux/dump_syms/dump_syms",
+        "thirdparty/breakpad/src/tools/mac/dump_syms/build/Release/dump_syms",
+        "thirdparty/breakpad/src/tools/windows/binaries/dump_syms.exe",
+        "thirdparty/breakpad/bin/dump_syms",
+        "thirdparty/breakpad/bin/dump_syms.exe",
+    ]:
+        candidate = os.path.join(root, candidate)
+        if os.path.isfile(candidate):
+            return candidate
+    return shutil.which("dump_syms")
+
+
+def _dump(dump_syms, binary, store):
+    """Runs dump_syms and files the output under the id from its MODULE line. Returns (symbol path, error)."""
+    handle, temp_path = tempfile.mkstemp(suffix=".sym", dir=store)
+    try:
+        with os.fdopen(handle, "wb") as output:
+            process = subprocess.run([dump_syms, binary], stdout=output, stderr=subprocess.PIPE)
+        if process.returncode != 0:
+            return None, process.stderr.decode("utf-8", "replace").strip()
+
+        # MODULE <os> <arch> <id> <name>
+        with open(temp_path, "rb") as output:
+            header = output.readline().decode("utf-8", "replace").split(" ", 4)
+        if len(header) != 5 or header[0] != "MODULE":
+            return None, "dump_syms gave no MODULE line"
+        symbol_path = get_symbol_path(store, header[4].strip(), header[3])
+
+        os.makedirs(os.path.dirname(symbol_path), exist_ok=True)
+        os.replace(temp_path, symbol_path)
+        return symbol_path, None
+    finally:
+        if os.path.exists(temp_path):
+            os.remove(temp_path)
+
+
+def _load_cache(store):
+    try:
+        with open(os.path.join(store, CACHE_FILE_NAME), "r") as f:
+            cache = json.load(f)
+        if cache.get("version") == CACHE_VERSION:
+            return cache["binaries"]
+    except (OSError, ValueError, KeyError):
+        pass
+    return {}
+
+
+def _save_cache(store, binaries):
+    path = os.path.join(store, CACHE_FILE_NAME)
+    with open(path + ".tmp", "w") as f:
+        json.dump({"version": CACHE_VERSION, "binaries": binaries}, f, indent=1, sort_keys=True)
+    os.replace(path + ".tmp", path)
+
+
+def generate(binaries, store, dump_syms="", jobs=0):
+    """Makes sure the store has symbols for all binaries. Returns a list of (binary, status, detail)."""
+    dump_syms = find_dump_syms(dump_syms)
+    if dump_syms is None:
+        return [(binary, "error", "dump_syms not found") for binary in binaries]
+    store = os.path.abspath(store)
+    os.makedirs(store, exist_ok=True)
+    cache = _load_cache(store)
+
+    def process(binary):
+        binary = os.path.abspath(binary)
+        if not os.path.isfile(binary):
+            return binary, "error", "not found", None
+
+        stat = os.stat(binary)
+        known = read_debug_id(binary)
+        if known is None:
+            cached = cache.get(binary)
+            if cached and cached["size"] == stat.st_size and cached["mtime"] == stat.st_mtime_ns:
+                known = (cached["id"], cached["module"])
+        if known is not None:
+            symbol_path = get_symbol_path(store, known[1], known[0])
+            if os.path.isfile(symbol_path):
+                return binary, "skipped", symbol_path, None
+
+        symbol_path, error = _dump(dump_syms, binary, store)
+        if error is not None:
+            return binary, "error", error, None
+        module_dir, debug_id = os.path.split(os.path.dirname(symbol_path))
+        entry = {"size": stat.st_size, "mtime": stat.st_mtime_ns, "id": debug_id, "module": os.path.basename(module_dir)}
+        return binary, "dumped", symbol_path, entry
+
+    # dump_syms is single threaded, so run one per core
+    with ThreadPoolExecutor(max_workers=jobs or os.cpu_count() or 1) as executor:
+        results = list(executor.map(process, binaries))
+
+    for binary, status, detail, entry in results:
+        if entry is not None:
+            cache[binary] = entry
+    _save_cache(store, cache)
+    return [(binary, status, detail) for binary, status, detail, entry in results]
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Generate Breakpad symbol files into a symbol store.")
+    parser.add_argument("binaries", nargs="+", help="executables and shared libraries")
+    parser.add_argument("--store", required=True, help="symbol store directory")
+    parser.add_argument("--dump-syms", default="", help="path to Breakpad's dump_syms (searched for by default)")
+    parser.add_argument("-j", "--jobs", type=int, default=0, help="parallel dump_syms runs (default: one per core)")
+    args = parser.parse_args()
+
+    failed = False
+    for binary, status, detail in generate(args.binaries, args.store, args.dump_syms, args.jobs):
+        print("%s: %s (%s)" % (status, binary, detail))
+        failed = failed or status == "error"
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,346 @@
+#!/usr/bin/env python
+"""Offline triage of a batch of minidumps.
+
+Finds the .dmp files in the given directories (e.g. crashpad_database_path of a QA machine),
+walks their crashing stacks against a local Breakpad symbol store (see crashpad_symbols.py)
+on all cores, and prints the crashes grouped by signature as JSON, most frequent first:
+    python crashpad_triage.py --symbols bin/symbols qa_spool/ > triage.json
+
+The stacks are found the same way the module's own crash signature does (CrashpadSignature):
+the crashing instruction, then return addresses found by scanning the top of the crashing
+thread's stack. With symbols, scanned addresses that are not inside a known function are
+dropped, and frames are named after their function, so the same bug groups together across
+builds. Each dump also gets the symbol-less signature the game computes for deduplication.
+
+Dumps and symbol files are memory mapped, and each symbol file is read once for all dumps.
+"""
+
+import argparse
+import hashlib
+import json
+import mmap
+import os
+import re
+import struct
+import sys
+from bisect import bisect_left
+from concurrent.futures import ProcessPoolExecutor
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from crashpad_symbols import get_symbol_path
+
+MINIDUMP_SIGNATURE = 0x504D444D  # "MDMP"
+MINIDUMP_VERSION = 0xA793
+
+MINIDUMP_STREAM_THREAD_LIST = 3
+MINIDUMP_STREAM_MODULE_LIST = 4
+MINIDUMP_STREAM_EXCEPTION = 6
+MINIDUMP_STREAM_SYSTEM_INFO = 7
+
+MINIDUMP_CPU_X86 = 0
+MINIDUMP_CPU_AMD64 = 9
+MINIDUMP_CPU_ARM64 = 12
+MINIDUMP_CPU_ARM64_OLD = 0x8003
+
+MINIDUMP_MODULE_SIZE = 108
+MINIDUMP_THREAD_SIZE = 48
+
+# Same limits as CrashpadSignature
+MAX_STREAMS = 256
+MAX_MODULES = 4096
+MAX_THREADS = 4096
+MAX_STACK_SCAN = 16384
+# Scanned candidates kept per dump, before symbols thin them out
+MAX_CANDIDATES = 256
+
+CV_SIGNATURE_PDB70 = b"RSDS"
+CV_SIGNATURE_ELF = b"BpEL"
+
+
+# Reading dumps (in the worker processes)
+
+
+def _read_string(data, rva):
+    length, = struct.unpack_from("<I", data, rva)
+    if length > 4096:
+        return ""
+    return bytes(data[rva + 4 : rva + 4 + length]).decode("utf-16-le", "replace")
+
+
+def _guid_id(raw, age):
+    guid = raw[:16].ljust(16, b"\0")
+    guid = guid[3::-1] + guid[5:3:-1] + guid[7:5:-1] + guid[8:]
+    return guid.hex().upper() + "%x" % age
+
+
+def _read_module(data, record):
+    """Returns (base, size, name for the signature, name in the symbol store, debug id)."""
+    base, size, name_rva = struct.unpack_from("<QI8xI", data, record)
+    path = _read_string(data, name_rva).replace("\\", "/")
+    file_name = path.split("/")[-1]
+    symbol_name = file_name
+    debug_id = None
+
+    cv_size, cv_rva = struct.unpack_from("<II", data, record + 76)
+    cv_signature = bytes(data[cv_rva : cv_rva + 4]) if cv_size >= 4 else b""
+    if cv_signature == CV_SIGNATURE_PDB70 and cv_size >= 24:
+        age, = struct.unpack_from("<I", data, cv_rva + 20)
+        debug_id = _guid_id(bytes(data[cv_rva + 4 : cv_rva + 20]), age)
+        pdb_name = bytes(data[cv_rva + 24 : cv_rva + cv_size]).split(b"\0")[0].decode("utf-8", "replace")
+        if pdb_name:
+            symbol_name = pdb_name.replace("\\", "/").split("/")[-1]
+    elif cv_signature == CV_SIGNATURE_ELF and cv_size > 4:
+        debug_id = _guid_id(bytes(data[cv_rva + 4 : cv_rva + cv_size]), 0)
+    return base, size, file_name.lower(), symbol_name, debug_id
+
+
+def _find_module(modules, address):
+    for index, module in enumerate(modules):
+        if module[0] <= address < module[0] + module[1]:
+            return index
+    return -1
+
+
+def read_dump(path):
+    """Reads the crash of one dump. Frames are (module index, offset) pairs, the first one is the crashing instruction."""
+    try:
+        with open(path, "rb") as f:
+            data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+    except (OSError, ValueError) as error:
+        return {"path": path, "error": str(error)}
+    try:
+        return _read_dump(path, data)
+    except (struct.error, IndexError, ValueError) as error:
+        return {"path": path, "error": "corrupt dump (%s)" % error}
+    finally:
+        data.close()
+
+
+def _read_dump(path, data):
+    signature, version, stream_count, directory_rva = struct.unpack_from("<IIII", data, 0)
+    if signature != MINIDUMP_SIGNATURE or (version & 0xFFFF) != MINIDUMP_VERSION:
+        return {"path": path, "error": "not a minidump"}
+
+    streams = {}
+    for i in range(min(stream_count, MAX_STREAMS)):
+        stream_type, _, stream_rva = struct.unpack_from("<III", data, directory_rva + i * 12)
+        streams.setdefault(stream_type, stream_rva)
+    if MINIDUMP_STREAM_EXCEPTION not in streams or MINIDUMP_STREAM_MODULE_LIST not in streams:
+        return {"path": path, "error": "no crash in dump"}
+
+    architecture = MINIDUMP_CPU_AMD64
+    if MINIDUMP_STREAM_SYSTEM_INFO in streams:
+        architecture, = struct.unpack_from("<H", data, streams[MINIDUMP_STREAM_SYSTEM_INFO])
+
+    module_list = streams[MINIDUMP_STREAM_MODULE_LIST]
+    module_count, = struct.unpack_from("<I", data, module_list)
+    modules = []
+    for i in range(min(module_count, MAX_MODULES)):
+        modules.append(_read_module(data, module_list + 4 + i * MINIDUMP_MODULE_SIZE))
+
+    exception = streams[MINIDUMP_STREAM_EXCEPTION]
+    thread_id, _, exception_code = struct.unpack_from("<III", data, exception)
+    exception_address, = struct.unpack_from("<Q", data, exception + 24)
+    context_rva, = struct.unpack_from("<I", data, exception + 164)
+
+    instruction_pointer = exception_address
+    stack_pointer = 0
+    link_register = 0
+    pointer_format = "<Q"
+    if architecture == MINIDUMP_CPU_AMD64:
+        stack_pointer, = struct.unpack_from("<Q", data, context_rva + 152)
+        instruction_pointer, = struct.unpack_from("<Q", data, context_rva + 248)
+    elif architecture == MINIDUMP_CPU_X86:
+        pointer_format = "<I"
+        instruction_pointer, = struct.unpack_from("<I", data, context_rva + 184)
+        stack_pointer, = struct.unpack_from("<I", data, context_rva + 196)
+    elif architecture in (MINIDUMP_CPU_ARM64, MINIDUMP_CPU_ARM64_OLD):
+        link_register, stack_pointer, instruction_pointer = struct.unpack_from("<QQQ", data, context_rva + 248)
+
+    frames = []
+    index = _find_module(modules, instruction_pointer)
+    frames.append((index, instruction_pointer - modules[index][0] if index >= 0 else instruction_pointer))
+    if link_register != 0:
+        index = _find_module(modules, link_register)
+        if index >= 0:
+            frames.append((index, link_register - modules[index][0]))
+
+    # Scan the top of the crashing thread's stack for return addresses
+    pointer_size = struct.calcsize(pointer_format)
+    thread_list = streams.get(MINIDUMP_STREAM_THREAD_LIST)
+    thread_count = struct.unpack_from("<I", data, thread_list)[0] if thread_list is not None else 0
+    for i in range(min(thread_count, MAX_THREADS)):
+        record = thread_list + 4 + i * MINIDUMP_THREAD_SIZE
+        if struct.unpack_from("<I", data, record)[0] != thread_id:
+            continue
+        stack_start, stack_size, stack_rva = struct.unpack_from("<QII", data, record + 24)
+        if not stack_start <= stack_pointer < stack_start + stack_size:
+            break
+        offset = stack_pointer - stack_start
+        end = min(stack_size, offset + MAX_STACK_SCAN)
+        while offset + pointer_size <= end and len(frames) < MAX_CANDIDATES:
+            value, = struct.unpack_from(pointer_format, data, stack_rva + offset)
+            index = _find_module(modules, value)
+            if index >= 0:
+                frames.append((index, value - modules[index][0]))
+            offset += pointer_size
+        break
+
+    return {
+        "path": path,
+        "exception_code": exception_code,
+        "modules": [(module[2], module[3], module[4]) for module in modules],
+        "frames": frames,
+    }
+
+
+# Symbols (in the worker processes, one symbol file per task)
+
+FUNC_PATTERN = re.compile(rb"^FUNC (?:m )?([0-9a-fA-F]+) ([0-9a-fA-F]+) [0-9a-fA-F]+ ([^\r\n]*)", re.M)
+PUBLIC_PATTERN = re.compile(rb"^PUBLIC (?:m )?([0-9a-fA-F]+) [0-9a-fA-F]+ ([^\r\n]*)", re.M)
+
+
+def resolve_symbols(task):
+    """Names the given module offsets from one .sym file. Returns (key, {offset: (name, inside a FUNC)}) or (key, None)."""
+    key, symbol_path, offsets = task
+    try:
+        with open(symbol_path, "rb") as f:
+            data = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+    except (OSError, ValueError):
+        return key, None
+
+    # Only the offsets asked for are kept, the symbol file itself is never loaded as a whole
+    offsets = sorted(set(offsets))
+    names = {}
+    publics = []
+    try:
+        for match in FUNC_PATTERN.finditer(data):
+            start = int(match.group(1), 16)
+            end = start + int(match.group(2), 16)
+            i = bisect_left(offsets, start)
+            while i < len(offsets) and offsets[i] < end:
+                names[offsets[i]] = (match.group(3).decode("utf-8", "replace"), True)
+                i += 1
+
+        # Stripped parts of the binary only have PUBLIC symbols: take the closest one below.
+        # Only their addresses and positions are kept, names are read for the ones used.
+        unnamed = [offset for offset in offsets if offset not in names]
+        if unnamed:
+            publics = sorted((int(match.group(1), 16), match.start()) for match in PUBLIC_PATTERN.finditer(data))
+            starts = [start for start, position in publics]
+            for offset in unnamed:
+                i = bisect_left(starts, offset + 1) - 1
+                if i >= 0:
+                    match = PUBLIC_PATTERN.match(data, publics[i][1])
+                    names[offset] = (match.group(2).decode("utf-8", "replace"), False)
+    finally:
+        data.close()
+
+    return key, names
+
+
+# Grouping
+
+
+def _hash(exception_code, frames):
+    # The same text and hash as CrashpadSignature::parse
+    return hashlib.md5(("%x|" % exception_code + "|".join(frames)).encode("utf-8")).hexdigest()
+
+
+def _raw_frame(dump, frame):
+    index, offset = frame
+    if index < 0:
+        return "<unknown>"
+    return "%s+0x%x" % (dump["modules"][index][0], offset)
+
+
+def triage(paths, symbol_stores, max_frames=5, jobs=0):
+    dump_paths = []
+    for path in paths:
+        if os.path.isdir(path):
+            for directory, _, files in os.walk(path):
+                dump_paths += [os.path.join(directory, name) for name in files if name.lower().endswith(".dmp")]
+        else:
+            dump_paths.append(path)
+    dump_paths.sort()
+
+    with ProcessPoolExecutor(max_workers=jobs or os.cpu_count() or 1) as executor:
+        chunk_size = max(1, len(dump_paths) // ((jobs or os.cpu_count() or 1) * 4))
+        dumps = list(executor.map(read_dump, dump_paths, chunksize=chunk_size))
+        failed = [{"path": dump["path"], "error": dump["error"]} for dump in dumps if "error" in dump]
+        dumps = [dump for dump in dumps if "error" not in dump]
+
+        # Gather every offset each symbol file has to name, so each one is read once
+        wanted = {}
+        for dump in dumps:
+            for index, offset in dump["frames"]:
+                if index >= 0 and dump["modules"][index][2] is not None:
+                    wanted.setdefault(dump["modules"][index][1:], []).append(offset)
+        tasks = []
+        for (symbol_name, debug_id), offsets in wanted.items():
+            for store in symbol_stores:
+                symbol_path = get_symbol_path(store, symbol_name, debug_id)
+                if os.path.isfile(symbol_path):
+                    tasks.append(((symbol_name, debug_id), symbol_path, offsets))
+                    break
+        symbols = dict(executor.map(resolve_symbols, tasks))
+
+    groups = {}
+    for dump in dumps:
+        frames = []
+        for position, (index, offset) in enumerate(dump["frames"]):
+            names = symbols.get(dump["modules"][index][1:]) if index >= 0 else None
+            if names is None:
+                # No symbols for this module, keep it like the game's signature does
+                frames.append(_raw_frame(dump, (index, offset)))
+            elif offset in names and (position == 0 or names[offset][1]):
+                frames.append("%s!%s" % (dump["modules"][index][0], names[offset][0]))
+            elif position == 0:
+                frames.append(_raw_frame(dump, (index, offset)))
+            # Otherwise a stale stack value outside any function, dropped
+            if len(frames) >= max_frames:
+                break
+
+        signature = _hash(dump["exception_code"], frames)
+        group = groups.get(signature)
+        if group is None:
+            group = groups[signature] = {
+                "signature": signature,
+                "exception_code": "0x%x" % dump["exception_code"],
+                "frames": frames,
+                "count": 0,
+                "dumps": [],
+            }
+        group["count"] += 1
+        raw_frames = [_raw_frame(dump, frame) for frame in dump["frames"][:max_frames]]
+        group["dumps"].append({"path": dump["path"], "game_signature": _hash(dump["exception_code"], raw_frames)})
+
+    return {
+        "dump_count": len(dump_paths),
+        "symbol_files": len(symbols),
+        "groups": sorted(groups.values(), key=lambda group: (-group["count"], group["signature"])),
+        "failed": failed,
+    }
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Group a batch of minidumps by crash signature, offline.")
+    parser.add_argument("dumps", nargs="+", help=".dmp files, or directories to search for them")
+    parser.add_argument("--symbols", action="append", default=[], help="symbol store directory (can be repeated)")
+    parser.add_argument("--frames", type=int, default=5, help="frames in a signature (default 5, like dedupe_stack_frames)")
+    parser.add_argument("-j", "--jobs", type=int, default=0, help="worker processes (default: one per core)")
+    parser.add_argument("-o", "--output", default="", help="write the JSON here instead of to stdout")
+    args = parser.parse_args()
+
+    result = triage(args.dumps, args.symbols, max(args.frames, 1), args.jobs)
+    if args.output:
+        with open(args.output, "w") as f:
+            json.dump(result, f, indent=1)
+    else:
+        json.dump(result, sys.stdout, indent=1)
+        sys.stdout.write("\n")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())